@@ -0,0 +1,62 @@
+#ifndef CACHE_FILE_HPP
+#define CACHE_FILE_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "../../lexer/include/source_buffer.hpp"
+
+namespace cache {
+
+    // Identifies the cache and version that wrote a file, so a file written
+    // by another is never mistaken for a usable one
+    struct EntryTag {
+        char magic[4];
+        uint32_t version;
+    };
+
+    // First bytes of every cache file. checksum covers everything after the
+    // cache's own header, so a corrupted payload is a miss rather than a
+    // wrong program.
+    struct EntryHeader {
+        EntryTag tag;
+        uint64_t checksum;
+    };
+
+    // One run of bytes written to an entry
+    struct Section {
+        const void* data;
+        size_t size;
+    };
+
+    // directory/<key as 16 hex digits><extension>
+    [[nodiscard]] std::string entry_path(const std::string& directory, uint64_t key, std::string_view extension);
+
+    // Maps the entry at path and copies its first header_size bytes into
+    // header, which must start with an EntryHeader. nullptr when the file is
+    // missing, unreadable, too short, its tag isn't tag or the bytes after
+    // the header don't match its checksum.
+    [[nodiscard]] std::unique_ptr<lexer::SourceBuffer> open_entry(
+        const std::string& path,
+        const EntryTag& tag,
+        void* header,
+        size_t header_size
+    );
+
+    // Writes header, then sections back to back, under a name unique to this
+    // process, then renames it over path. Readers never see a half written
+    // entry. header must start with an EntryHeader, its checksum is filled
+    // in here. Failing to write is not an error, the next run just misses.
+    void write_entry(
+        const std::string& path,
+        void* header,
+        size_t header_size,
+        std::initializer_list<Section> sections
+    );
+
+}
+
+#endif //CACHE_FILE_HPP
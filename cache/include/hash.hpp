@@ -0,0 +1,20 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace cache {
+
+    // 64-bit FNV-1a. Stable across runs and platforms, so it can key files
+    // on disk.
+    [[nodiscard]] uint64_t hash_bytes(std::string_view bytes);
+
+    // Eight bytes per step, for verifying large payloads. Unrelated to
+    // hash_bytes, so bytes built to collide under one still differ here.
+    // Changing any single word of the input always changes the result.
+    [[nodiscard]] uint64_t checksum(std::string_view bytes);
+
+}
+
+#endif //HASH_HPP
@@ -0,0 +1,119 @@
+#include "../include/cache_file.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "../include/hash.hpp"
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace cache {
+
+    static unsigned long process_id() {
+    #if defined(_WIN32)
+        return static_cast<unsigned long>(_getpid());
+    #else
+        return static_cast<unsigned long>(getpid());
+    #endif
+    }
+
+    // Two compilers storing the same entry at once each write their own
+    // file, whichever renames last wins
+    static std::string temp_path_for(const std::string& path) {
+        static std::atomic<unsigned> counter = 0;
+
+        return path + "." + std::to_string(process_id()) + "." + std::to_string(counter++) + ".tmp";
+    }
+
+    std::string entry_path(const std::string& directory, const uint64_t key, const std::string_view extension) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+        return (std::filesystem::path(directory) / (name + std::string(extension))).string();
+    }
+
+    std::unique_ptr<lexer::SourceBuffer> open_entry(
+        const std::string& path,
+        const EntryTag& tag,
+        void* header,
+        const size_t header_size
+    ) {
+        if (!std::filesystem::exists(path)) {
+            return nullptr;
+        }
+
+        std::unique_ptr<lexer::SourceBuffer> file;
+
+        try {
+            file = std::make_unique<lexer::SourceBuffer>(path);
+        } catch (const std::runtime_error&) {
+            return nullptr;
+        }
+
+        const std::string_view bytes = file->view();
+
+        if (bytes.length() < header_size || std::memcmp(bytes.data(), &tag, sizeof(EntryTag)) != 0) {
+            return nullptr;
+        }
+
+        std::memcpy(header, bytes.data(), header_size);
+
+        if (static_cast<const EntryHeader*>(header)->checksum != checksum(bytes.substr(header_size))) {
+            return nullptr;
+        }
+
+        return file;
+    }
+
+    void write_entry(
+        const std::string& path,
+        void* header,
+        const size_t header_size,
+        const std::initializer_list<Section> sections
+    ) {
+        std::string payload;
+
+        for (const Section& section : sections) {
+            payload.append(static_cast<const char*>(section.data), section.size);
+        }
+
+        static_cast<EntryHeader*>(header)->checksum = checksum(payload);
+
+        const std::string temp_path = temp_path_for(path);
+
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+
+            if (!out.is_open()) {
+                return;
+            }
+
+            out.write(static_cast<const char*>(header), static_cast<std::streamsize>(header_size));
+            out.write(payload.data(), static_cast<std::streamsize>(payload.length()));
+
+            if (!out) {
+                out.close();
+                std::filesystem::remove(temp_path, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp_path, path, ec);
+
+        if (ec) {
+            std::filesystem::remove(temp_path, ec);
+        }
+    }
+
+}
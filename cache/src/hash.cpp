@@ -0,0 +1,45 @@
+#include "../include/hash.hpp"
+
+#include <cstring>
+
+namespace cache {
+
+    // Odd multiply and xorshift are both invertible, so every step maps
+    // distinct states to distinct states
+    static uint64_t absorb(const uint64_t h, const uint64_t word) {
+        const uint64_t x = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        return x ^ x >> 32;
+    }
+
+    uint64_t hash_bytes(const std::string_view bytes) {
+        uint64_t h = 14695981039346656037ull;
+
+        for (const char c : bytes) {
+            h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+
+        return h;
+    }
+
+    uint64_t checksum(const std::string_view bytes) {
+        // Seeding with the length keeps trailing zero bytes significant
+        uint64_t h = 0x9E3779B97F4A7C15ull ^ bytes.length();
+        size_t i = 0;
+
+        for (; i + sizeof(uint64_t) <= bytes.length(); i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            h = absorb(h, word);
+        }
+
+        if (i < bytes.length()) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes.data() + i, bytes.length() - i);
+            h = absorb(h, word);
+        }
+
+        h = (h ^ h >> 33) * 0xC4CEB9FE1A85EC53ull;
+        return h ^ h >> 33;
+    }
+
+}
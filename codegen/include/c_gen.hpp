@@ -1,38 +1,39 @@
 #ifndef C_GEN_HPP
 #define C_GEN_HPP
-#include "../../parser/include/ast_nodes.hpp"
-#include <unordered_map>
-#include <unordered_set>
+#include <ostream>
+#include <set>
+#include <string_view>
 #include "c_libs.hpp"
-#include "variable.hpp"
+#include "c_runtime.hpp"
+#include "../../ir/include/ir.hpp"
 
 namespace codegen {
 
+    // Final lowering from IR to C. Constants are emitted inline, every
+    // other value becomes a const local named after its ValueId.
     class CGen {
-        std::unordered_set<CLibrary> libraries{};
-        VariableMap variables{};
+        const ir::Function& function;
+        // Ordered so the emitted C is the same from run to run
+        std::set<CLibrary> libraries{};
+        std::set<CRuntimeHelper> helpers{};
 
-        parser::ASTNode* fold_binary_op(parser::BinaryOp* node);
+        void gen_constant(ir::ValueId value, std::ostream& out);
+        void gen_value(ir::ValueId value, std::ostream& out);
+        void gen_helper_call(CRuntimeHelper helper, const ir::Instruction& inst, std::ostream& out);
+        void gen_expr(const ir::Instruction& inst, std::ostream& out);
 
-        void gen_string_literal(parser::StringLiteral* node, std::ostream& out);
-        void gen_float(parser::Float* node, std::ostream& out);
-        void gen_integer(parser::Integer* node, std::ostream& out);
-        void gen_identifier(parser::Identifier* node, std::ostream& out);
-
-        void gen_primary_value(parser::ASTNode* node, std::ostream& out);
-        void gen_value(parser::ASTNode* node, std::ostream& out);
-
-        void gen_builtin_func(parser::BuiltInFunc* node, std::ostream& out);
-        void gen_imm_declare(parser::ImmDeclare* node, std::ostream& out);
-        void gen_mut_declare(parser::MutDeclare* node, std::ostream& out);
-        void gen_assign_var(parser::AssignVar* node, std::ostream& out);
-
-        void gen_statement(parser::ASTNode* ast, std::ostream& out);
+        void gen_text(ir::ValueId name, std::string_view text, std::ostream& out);
+        void gen_print(ir::ValueId value, std::ostream& out);
+        void gen_write(ir::ValueId value, std::ostream& out);
+        void gen_definition(ir::ValueId value, std::ostream& out);
 
         void require_lib(CLibrary lib);
+        void require_helper(CRuntimeHelper helper);
 
     public:
-        void generate(std::vector<std::unique_ptr<parser::ASTNode>>& asts, std::ostream& out);
+        explicit CGen(const ir::Function& function);
+
+        void generate(std::ostream& out);
     };
 
 }
@@ -7,7 +7,9 @@
 namespace codegen {
 
     enum CLibrary {
-        STDIO
+        STDIO,
+        STDLIB,
+        STRING
     };
 
     std::string get_library_str(CLibrary lib);
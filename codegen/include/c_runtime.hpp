@@ -0,0 +1,32 @@
+#ifndef C_RUNTIME_HPP
+#define C_RUNTIME_HPP
+
+#include <string>
+#include <vector>
+
+#include "c_libs.hpp"
+
+namespace codegen {
+
+    // Helper functions emitted into the generated C when an expression
+    // can only be evaluated at runtime. They are emitted in this order,
+    // so a helper may call any listed before it.
+    enum CRuntimeHelper {
+        CONCAT,
+        INT_TO_STR,
+        FLOAT_TO_STR,
+        OUTPUT,
+        WRITE_STR,
+        WRITE_INT,
+        WRITE_FLOAT
+    };
+
+    std::string get_runtime_helper_name(CRuntimeHelper helper);
+
+    std::string get_runtime_helper_src(CRuntimeHelper helper);
+
+    std::vector<CLibrary> get_runtime_helper_libs(CRuntimeHelper helper);
+
+}
+
+#endif //C_RUNTIME_HPP
@@ -1,357 +1,290 @@
 #include "../include/c_gen.hpp"
 
-#include <cassert>
-#include <iostream>
-
-#include "../include/code_gen_error.hpp"
+#include <limits>
 #include <sstream>
-#include <variant>
 
-#include "../include/evaluator.hpp"
+#include "../include/code_gen_error.hpp"
+#include "../../ir/include/number_format.hpp"
 
 namespace codegen {
 
-    parser::ASTNode* CGen::fold_binary_op(parser::BinaryOp* node) {
-        const auto val = evaluate_binary_op(node, variables);
-
-        if (std::holds_alternative<std::string>(val)) {
-            return new parser::StringLiteral(std::get<std::string>(val));
-        }
-
-        if (std::holds_alternative<float>(val)) {
-            return new parser::Float(std::get<float>(val));
-        }
-
-        if (std::holds_alternative<int>(val)) {
-            return new parser::Integer(std::get<int>(val));
+    static const char* c_type(const ir::Type type) {
+        switch (type) {
+            case ir::STRING: return "const char*";
+            case ir::FLOAT: return "const float";
+            case ir::INTEGER: return "const int";
+            default:
+                throw CodeGenError("Invalid value type for definition.");
         }
-
-        throw CodeGenError("Unsupported result in fold_binary_op.");
-    }
-
-    void CGen::gen_string_literal(parser::StringLiteral* node, std::ostream& out) {
-        out << "\"" << node->content << "\"";
-    }
-
-    void CGen::gen_float(parser::Float* node, std::ostream& out) {
-        out << std::to_string(node->value) + "f";
     }
 
-    void CGen::gen_integer(parser::Integer* node, std::ostream& out) {
-        out << node->value;
-    }
-
-    void CGen::gen_identifier(parser::Identifier* node, std::ostream& out) {
-        out << node->name;
-    }
-
-    void CGen::gen_primary_value(parser::ASTNode* node, std::ostream& out) {
-        if (auto str = dynamic_cast<parser::StringLiteral*>(node)) {
-            gen_string_literal(str, out);
-        } else if (auto f_val = dynamic_cast<parser::Float*>(node)) {
-            gen_float(f_val, out);
-        } else if (auto i_val = dynamic_cast<parser::Integer*>(node)) {
-            gen_integer(i_val, out);
-        } else {
-            throw CodeGenError("Invalid AST for value.");
+    static const char* c_operator(const ir::Opcode op) {
+        switch (op) {
+            case ir::ADD: return "+";
+            case ir::SUBTRACT: return "-";
+            case ir::MULTIPLY: return "*";
+            case ir::DIVIDE: return "/";
+            default: return "";
         }
     }
 
-    void CGen::gen_value(parser::ASTNode* node, std::ostream& out) {
-        if (auto bin_op = dynamic_cast<parser::BinaryOp*>(node)) {
-            std::unique_ptr<parser::ASTNode> folded;
-
-            try {
-                folded.reset(fold_binary_op(bin_op));
-            } catch (...) {
-                //
-            }
-
-            if (folded) {
-                gen_primary_value(folded.get(), out);
-                return;
-            }
+    static CRuntimeHelper writer_for(const ir::Type type) {
+        switch (type) {
+            case ir::STRING: return WRITE_STR;
+            case ir::FLOAT: return WRITE_FLOAT;
+            case ir::INTEGER: return WRITE_INT;
+            default:
+                throw CodeGenError("Invalid value type for print.");
         }
-
-        gen_primary_value(node, out);
     }
 
-    void CGen::gen_builtin_func(parser::BuiltInFunc* node, std::ostream& out) {
-        const std::string& name = node->func_name;
-
-        if (name == "print") {
-            require_lib(STDIO);
-
-            out << "printf(";
-
-            if (auto iden_val = dynamic_cast<parser::Identifier*>(node->arg.get())) {
-                if (!variables.contains(iden_val->name)) {
-                    throw CodeGenError("Attempted to use undefined variable '" + iden_val->name + "'.");
-                }
+    // Round trips exactly, unlike %f which keeps six decimals
+    static void gen_float_literal(const float value, std::ostream& out) {
+        if (value != value) {
+            out << "(0.0f / 0.0f)";
+            return;
+        }
 
-                parser::ASTValueType v_type = variables.at(iden_val->name).type;
-                assert(v_type != parser::IDENTIFIER);
-
-                switch (variables.at(iden_val->name).type) {
-                    case parser::STRING_LITERAL: {
-                        out << "\"%s\", " << iden_val->name;
-                    } break;
-                    case parser::FLOAT: {
-                        out << "\"%f\", " << iden_val->name;
-                    } break;
-                    case parser::INTEGER: {
-                        out << "\"%i\", " << iden_val->name;
-                    } break;
-                    default: break;
-                }
-            } else if (auto str = dynamic_cast<parser::StringLiteral*>(node->arg.get())) {
-                out << "\"%s\", ";
-                gen_string_literal(str, out);
-            } else if (auto f_val = dynamic_cast<parser::Float*>(node->arg.get())) {
-                out << "\"%f\", ";
-                gen_float(f_val, out);
-            } else if (auto i_val = dynamic_cast<parser::Integer*>(node->arg.get())) {
-                out << "\"%i\", ";
-                gen_integer(i_val, out);
-            }
+        ir::NumberBuffer buffer;
+        const std::string_view digits = ir::format_float_shortest(buffer, value);
 
-            out << ");";
+        if (digits == "inf" || digits == "-inf") {
+            out << "(" << (value < 0 ? "-" : "") << "1.0f / 0.0f)";
             return;
         }
 
-        if (name == "println") {
-            require_lib(STDIO);
+        out << digits;
 
-            out << "printf(";
-
-            if (auto iden_val = dynamic_cast<parser::Identifier*>(node->arg.get())) {
-                if (!variables.contains(iden_val->name)) {
-                    throw CodeGenError("Attempted to use undefined variable '" + iden_val->name + "'.");
-                }
+        // "3f" isn't a C float literal, "3.0f" and "1e+10f" are
+        if (digits.find_first_of(".e") == std::string_view::npos) {
+            out << ".0";
+        }
 
-                parser::ASTValueType v_type = variables.at(iden_val->name).type;
-                assert(v_type != parser::IDENTIFIER);
-
-                switch (variables.at(iden_val->name).type) {
-                    case parser::STRING_LITERAL: {
-                        out << R"("%s\n", )" << iden_val->name;
-                    } break;
-                    case parser::FLOAT: {
-                        out << R"("%f\n", )" << iden_val->name;
-                    } break;
-                    case parser::INTEGER: {
-                        out << R"("%i\n", )" << iden_val->name;
-                    } break;
-                    default: break;
-                }
-            } else if (auto str = dynamic_cast<parser::StringLiteral*>(node->arg.get())) {
-                out << R"("%s\n", )";
-                gen_string_literal(str, out);
-            } else if (auto f_val = dynamic_cast<parser::Float*>(node->arg.get())) {
-                out << R"("%f\n", )";
-                gen_float(f_val, out);
-            } else if (auto i_val = dynamic_cast<parser::Integer*>(node->arg.get())) {
-                out << R"("%i\n", )";
-                gen_integer(i_val, out);
-            }
+        out << "f";
+    }
 
-            out << ");";
+    static void gen_integer_literal(const int value, std::ostream& out) {
+        // 2147483648 doesn't fit an int, so -2147483648 would be a long
+        if (value == std::numeric_limits<int>::min()) {
+            out << "(-2147483647 - 1)";
             return;
         }
 
-        throw CodeGenError("Unsupported function '" + node->func_name + "!'.");
+        ir::NumberBuffer buffer;
+        out << ir::format_integer(buffer, value);
     }
 
-    void CGen::gen_imm_declare(parser::ImmDeclare* node, std::ostream &out) {
-        auto identifier = dynamic_cast<parser::Identifier*>(node->identifier.get());
+    // IR strings are raw bytes. Anything outside printable ASCII becomes a
+    // three digit octal escape, which can't run into the next character.
+    static void gen_string_literal(const std::string_view bytes, std::ostream& out) {
+        out << "\"";
 
-        if (!identifier) {
-            throw CodeGenError("Expected identifier in immutable declaration.");
-        }
+        size_t run = 0;
 
-        if (variables.contains(identifier->name)) {
-            throw CodeGenError("Variable '" + identifier->name + "' already declared.");
-        }
+        for (size_t i = 0; i < bytes.length(); i++) {
+            const auto c = static_cast<unsigned char>(bytes[i]);
 
-        if (auto bin_op = dynamic_cast<parser::BinaryOp*>(node->value.get())) {
-            try {
-                node->value.reset(fold_binary_op(bin_op));
-            } catch (...) {
-                //
+            if (c >= 0x20 && c != 0x7f && c != '"' && c != '\\') {
+                continue;
             }
-        }
-
-        auto val_type = parser::get_var_type_from_node(node->value.get());
-
-        std::string c_type;
-        switch (val_type) {
-            case parser::STRING_LITERAL: c_type = "const char*"; break;
-            case parser::FLOAT: c_type = "const float"; break;
-            case parser::INTEGER: c_type = "const int"; break;
-            default:
-                throw CodeGenError("Unsupported type in immutable declaration.");
-        }
-
-        ValueVariant init_val;
-        bool saw_literal = false;
-
-        if (auto str = dynamic_cast<parser::StringLiteral*>(node->value.get())) {
-            init_val = str->content;
-            saw_literal = true;
-        } else if (auto f_val = dynamic_cast<parser::Float*>(node->value.get())) {
-            init_val = f_val->value;
-            saw_literal = true;
-        } else if (auto i_val = dynamic_cast<parser::Integer*>(node->value.get())) {
-            init_val = i_val->value;
-            saw_literal = true;
-        }
-
-        variables.emplace(
-            identifier->name,
-            Variable{ val_type, ValueVariant{}, false }
-        );
 
-        if (saw_literal) {
-            variables[identifier->name].value = std::move(init_val);
+            out.write(bytes.data() + run, static_cast<std::streamsize>(i - run));
+            run = i + 1;
+
+            switch (c) {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default: {
+                    const char octal[] = {
+                        '\\',
+                        static_cast<char>('0' + (c >> 6)),
+                        static_cast<char>('0' + (c >> 3 & 7)),
+                        static_cast<char>('0' + (c & 7))
+                    };
+                    out.write(octal, sizeof(octal));
+                }
+            }
         }
 
-        out << c_type << " ";
-        gen_identifier(identifier, out);
-        out << " = ";
-        gen_value(node->value.get(), out);
-        out << ";";
+        out.write(bytes.data() + run, static_cast<std::streamsize>(bytes.length() - run));
+        out << "\"";
     }
 
-    void CGen::gen_mut_declare(parser::MutDeclare* node, std::ostream& out) {
-        if (auto bin_op = dynamic_cast<parser::BinaryOp*>(node->value.get())) {
-            node->value.reset(fold_binary_op(bin_op));
+    void CGen::gen_constant(const ir::ValueId value, std::ostream& out) {
+        switch (function[value].type) {
+            case ir::STRING: gen_string_literal(function.string_value(value), out); break;
+            case ir::FLOAT: gen_float_literal(function.float_value(value), out); break;
+            case ir::INTEGER: gen_integer_literal(function.integer_value(value), out); break;
+            default:
+                throw CodeGenError("Invalid constant type.");
         }
+    }
 
-        parser::ASTValueType val_type;
-        if (dynamic_cast<parser::StringLiteral*>(node->value.get())) {
-            out << "const char* ";
-            val_type = parser::STRING_LITERAL;
-        } else if (dynamic_cast<parser::Float*>(node->value.get())) {
-            out << "float ";
-            val_type = parser::FLOAT;
-        } else if (dynamic_cast<parser::Integer*>(node->value.get())) {
-            out << "int ";
-            val_type = parser::INTEGER;
+    void CGen::gen_value(const ir::ValueId value, std::ostream& out) {
+        if (function.is_constant(value)) {
+            gen_constant(value, out);
         } else {
-            throw CodeGenError("Invalid variable type for declaration.");
+            out << "t" << value;
         }
+    }
 
-        if (auto identifier = dynamic_cast<parser::Identifier*>(node->identifier.get())) {
-            if (variables.contains(identifier->name)) {
-                throw CodeGenError("Variable with name '" + identifier->name + "' already defined.");
-            }
-
-            ValueVariant val;
-            if (auto str = dynamic_cast<parser::StringLiteral*>(node->value.get())) {
-                val = str->content;
-            } else if (auto f_val = dynamic_cast<parser::Float*>(node->value.get())) {
-                val = f_val->value;
-            } else if (auto i_val = dynamic_cast<parser::Integer*>(node->value.get())) {
-                val = i_val->value;
-            }
+    void CGen::gen_helper_call(const CRuntimeHelper helper, const ir::Instruction& inst, std::ostream& out) {
+        require_helper(helper);
 
-            variables.insert({
-                identifier->name,
-                Variable{
-                    val_type,
-                    val,
-                    true
-                }
-            });
+        out << get_runtime_helper_name(helper) << "(";
+        gen_value(inst.a, out);
 
-            gen_identifier(identifier, out);
-        } else {
-            throw CodeGenError("Expected identifier in immutable declaration.");
+        if (ir::operand_count(inst.op) > 1) {
+            out << ", ";
+            gen_value(inst.b, out);
         }
 
-        out << " = ";
-        gen_value(node->value.get(), out);
-        out << ";";
+        out << ")";
     }
 
-    void CGen::gen_assign_var(parser::AssignVar* node, std::ostream& out) {
-        if (auto bin_op = dynamic_cast<parser::BinaryOp*>(node->value.get())) {
-            node->value.reset(fold_binary_op(bin_op));
+    void CGen::gen_expr(const ir::Instruction& inst, std::ostream& out) {
+        switch (inst.op) {
+            case ir::COPY: gen_value(inst.a, out); break;
+            case ir::ADD:
+            case ir::SUBTRACT:
+            case ir::MULTIPLY:
+            case ir::DIVIDE: {
+                gen_value(inst.a, out);
+                out << " " << c_operator(inst.op) << " ";
+                gen_value(inst.b, out);
+            } break;
+            case ir::CONCAT: gen_helper_call(CONCAT, inst, out); break;
+            case ir::INT_TO_FLOAT: {
+                out << "(float)";
+                gen_value(inst.a, out);
+            } break;
+            case ir::INT_TO_STRING: gen_helper_call(INT_TO_STR, inst, out); break;
+            case ir::FLOAT_TO_STRING: gen_helper_call(FLOAT_TO_STR, inst, out); break;
+            default:
+                throw CodeGenError("Instruction has no C expression.");
         }
+    }
 
-        std::string identifier_str;
+    // name is the id of the instruction printing text. sizeof also counts
+    // any NUL bytes inside it.
+    void CGen::gen_text(const ir::ValueId name, const std::string_view text, std::ostream& out) {
+        require_helper(OUTPUT);
 
-        if (auto identifier = dynamic_cast<parser::Identifier*>(node->identifier.get())) {
-            if (!variables.contains(identifier->name)) {
-                throw CodeGenError("Attempting to assign an undefined variable with name '" + identifier->name + "'.");
+        out << "static const char t" << name << "[] = ";
+        gen_string_literal(text, out);
+        out << ";\n";
+        out << get_runtime_helper_name(OUTPUT) << "(t" << name << ", sizeof(t" << name << ") - 1);";
+    }
+
+    // Constants are formatted now, only runtime values go through a writer
+    void CGen::gen_print(const ir::ValueId value, std::ostream& out) {
+        const ir::Instruction& inst = function[value];
+        const char* newline = inst.b ? "\n" : "";
+
+        if (function.is_constant(inst.a)) {
+            ir::NumberBuffer buffer;
+            std::string text;
+
+            switch (function[inst.a].type) {
+                case ir::STRING: text = function.string_value(inst.a); break;
+                case ir::FLOAT: text = ir::format_float(buffer, function.float_value(inst.a)); break;
+                case ir::INTEGER: text = ir::format_integer(buffer, function.integer_value(inst.a)); break;
+                default:
+                    throw CodeGenError("Invalid value type for print.");
             }
 
-            identifier_str = identifier->name;
-            gen_identifier(identifier, out);
-        } else {
-            throw CodeGenError("Expected identifier in immutable declaration.");
+            gen_text(value, text + newline, out);
+            return;
         }
 
-        const auto prev_state = variables.at(identifier_str);
+        const CRuntimeHelper writer = writer_for(function[inst.a].type);
 
-        if (!prev_state.muttable) {
-            throw CodeGenError("Attempting to mutate an immutable variable.");
-        }
+        require_helper(OUTPUT);
+        require_helper(writer);
 
-        const auto new_type = parser::get_var_type_from_node(
-            node->value.get()
-        );
+        out << get_runtime_helper_name(writer) << "(";
+        gen_value(inst.a, out);
+        out << ");";
 
-        if (prev_state.type != new_type) {
-            throw CodeGenError(
-                "Attempted to assign wrong type to variable '" + identifier_str + "':\n" +
-                parser::ast_val_type_str(prev_state.type) + " -> " + parser::ast_val_type_str(new_type)
-            );
+        if (inst.b) {
+            out << "\n" << get_runtime_helper_name(OUTPUT) << "(\"\\n\", 1);";
         }
+    }
 
-        out << " = ";
-        gen_value(node->value.get(), out);
-        out << ";";
+    void CGen::gen_write(const ir::ValueId value, std::ostream& out) {
+        gen_text(value, function.flatten(function[value].a), out);
     }
 
-    void CGen::gen_statement(parser::ASTNode* ast, std::ostream& out) {
-        if (auto imm_declare = dynamic_cast<parser::ImmDeclare*>(ast)) {
-            gen_imm_declare(imm_declare, out);
-        } else if (auto mut_declare = dynamic_cast<parser::MutDeclare*>(ast)) {
-            gen_mut_declare(mut_declare, out);
-        } else if (auto assign_var = dynamic_cast<parser::AssignVar*>(ast)) {
-            gen_assign_var(assign_var, out);
-        } else if (auto builtin_func = dynamic_cast<parser::BuiltInFunc*>(ast)) {
-            gen_builtin_func(builtin_func, out);
-        } else {
-            throw CodeGenError("Unidentified statement AST.");
-        }
+    void CGen::gen_definition(const ir::ValueId value, std::ostream& out) {
+        const ir::Instruction& inst = function[value];
+
+        out << c_type(inst.type) << " t" << value << " = ";
+        gen_expr(inst, out);
+        out << ";";
     }
 
-    void CGen::generate(std::vector<std::unique_ptr<parser::ASTNode>>& asts, std::ostream& out) {
+    CGen::CGen(const ir::Function& function)
+        : function(function) {}
+
+    void CGen::generate(std::ostream& out) {
         std::ostringstream body;
         std::ostringstream includes;
 
-        body << "int main(void) {\n";
-        for (size_t i = 0; i < asts.size(); i++) {
-            gen_statement(asts[i].get(), body);
+        for (ir::ValueId value = 0; value < function.size(); value++) {
+            const ir::Instruction& inst = function[value];
+
+            if (inst.op == ir::CONST) {
+                continue;
+            }
 
-            if (i != asts.size() - 1) {
-                body << "\n";
+            if (inst.op == ir::PRINT) {
+                gen_print(value, body);
+            } else if (inst.op == ir::WRITE) {
+                gen_write(value, body);
+            } else {
+                gen_definition(value, body);
             }
+
+            body << "\n";
+        }
+
+        std::ostringstream runtime;
+
+        for (const auto& helper : helpers) {
+            runtime << get_runtime_helper_src(helper);
         }
-        body << "\nreturn 0;\n}\n";
 
         for (const auto& lib : libraries) {
             includes << "#include <" << get_library_str(lib) << ">\n";
         }
 
+        const bool buffered = helpers.contains(OUTPUT);
+
         out << includes.str();
+        out << runtime.str();
+        out << "int main(void) {\n";
+        if (buffered) {
+            out << "setvbuf(stdout, NULL, _IONBF, 0);\n";
+        }
         out << body.str();
+        if (buffered) {
+            out << "cherry_flush();\n";
+        }
+        out << "return 0;\n}\n";
     }
 
     void CGen::require_lib(CLibrary lib) {
         libraries.insert(lib);
     }
 
+    void CGen::require_helper(const CRuntimeHelper helper) {
+        if (helpers.insert(helper).second) {
+            for (const CLibrary lib : get_runtime_helper_libs(helper)) {
+                require_lib(lib);
+            }
+        }
+    }
+
 }
@@ -5,7 +5,9 @@
 namespace codegen {
 
     static const std::vector<std::pair<CLibrary, std::string>> c_libraries = {
-        { STDIO, "stdio.h" }
+        { STDIO, "stdio.h" },
+        { STDLIB, "stdlib.h" },
+        { STRING, "string.h" }
     };
 
     std::string get_library_str(CLibrary lib) {
@@ -0,0 +1,135 @@
+#include <cassert>
+
+#include "../include/c_runtime.hpp"
+
+namespace codegen {
+
+    struct RuntimeHelperInfo {
+        CRuntimeHelper helper;
+        std::string name;
+        std::string src;
+        std::vector<CLibrary> libs;
+    };
+
+    // Strings built at runtime are never freed, programs are short lived.
+    // Float formatting matches what the constant folder produces.
+    static const std::vector<RuntimeHelperInfo> runtime_helpers = {
+        {
+            CONCAT,
+            "cherry_concat",
+            "static const char* cherry_concat(const char* l, const char* r) {\n"
+            "const size_t l_len = strlen(l);\n"
+            "const size_t r_len = strlen(r);\n"
+            "char* s = malloc(l_len + r_len + 1);\n"
+            "memcpy(s, l, l_len);\n"
+            "memcpy(s + l_len, r, r_len + 1);\n"
+            "return s;\n"
+            "}\n",
+            { STDLIB, STRING }
+        },
+        {
+            INT_TO_STR,
+            "cherry_int_str",
+            "static const char* cherry_int_str(int v) {\n"
+            "char* s = malloc(16);\n"
+            "snprintf(s, 16, \"%i\", v);\n"
+            "return s;\n"
+            "}\n",
+            { STDIO, STDLIB }
+        },
+        {
+            FLOAT_TO_STR,
+            "cherry_float_str",
+            "static const char* cherry_float_str(float v) {\n"
+            "const int len = snprintf(NULL, 0, \"%f\", v);\n"
+            "char* s = malloc(len + 1);\n"
+            "snprintf(s, len + 1, \"%f\", v);\n"
+            "return s;\n"
+            "}\n",
+            { STDIO, STDLIB }
+        },
+        // All output goes through one buffer, written out when full and
+        // once at exit. stdout is left unbuffered, so each flush is a
+        // single write.
+        {
+            OUTPUT,
+            "cherry_write",
+            "static char cherry_out[1 << 16];\n"
+            "static size_t cherry_out_len = 0;\n"
+            "static void cherry_flush(void) {\n"
+            "fwrite(cherry_out, 1, cherry_out_len, stdout);\n"
+            "cherry_out_len = 0;\n"
+            "}\n"
+            "static void cherry_write(const char* s, size_t n) {\n"
+            "if (n > sizeof(cherry_out) - cherry_out_len) {\n"
+            "cherry_flush();\n"
+            "if (n > sizeof(cherry_out)) {\n"
+            "fwrite(s, 1, n, stdout);\n"
+            "return;\n"
+            "}\n"
+            "}\n"
+            "memcpy(cherry_out + cherry_out_len, s, n);\n"
+            "cherry_out_len += n;\n"
+            "}\n",
+            { STDIO, STRING }
+        },
+        {
+            WRITE_STR,
+            "cherry_write_str",
+            "static void cherry_write_str(const char* s) {\n"
+            "cherry_write(s, strlen(s));\n"
+            "}\n",
+            { STRING }
+        },
+        {
+            WRITE_INT,
+            "cherry_write_int",
+            "static void cherry_write_int(int v) {\n"
+            "char s[12];\n"
+            "char* p = s + sizeof(s);\n"
+            "unsigned int u = v < 0 ? 0u - (unsigned int)v : (unsigned int)v;\n"
+            "do {\n"
+            "*--p = (char)('0' + u % 10);\n"
+            "u /= 10;\n"
+            "} while (u);\n"
+            "if (v < 0) *--p = '-';\n"
+            "cherry_write(p, (size_t)(s + sizeof(s) - p));\n"
+            "}\n",
+            {}
+        },
+        {
+            WRITE_FLOAT,
+            "cherry_write_float",
+            "static void cherry_write_float(float v) {\n"
+            "char s[64];\n"
+            "const int len = snprintf(s, sizeof(s), \"%f\", v);\n"
+            "cherry_write(s, (size_t)len);\n"
+            "}\n",
+            { STDIO }
+        }
+    };
+
+    static const RuntimeHelperInfo& find_helper(const CRuntimeHelper helper) {
+        for (const auto& info : runtime_helpers) {
+            if (info.helper == helper) {
+                return info;
+            }
+        }
+
+        assert(false && "C runtime helper not found from enum");
+        return runtime_helpers.front();
+    }
+
+    std::string get_runtime_helper_name(const CRuntimeHelper helper) {
+        return find_helper(helper).name;
+    }
+
+    std::string get_runtime_helper_src(const CRuntimeHelper helper) {
+        return find_helper(helper).src;
+    }
+
+    std::vector<CLibrary> get_runtime_helper_libs(const CRuntimeHelper helper) {
+        return find_helper(helper).libs;
+    }
+
+}
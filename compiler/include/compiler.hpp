@@ -20,6 +20,8 @@ namespace compiler {
 
         bool compile_c_file(const std::string& src_file, const std::string& compiler);
 
+        bool binary_up_to_date() const;
+
         void run_binary();
 
         void clear_screen();
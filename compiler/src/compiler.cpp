@@ -21,6 +21,20 @@ namespace compiler {
         return std::system(command.c_str()) == 0;
     }
 
+    // The C file is only rewritten when it changes, so a binary newer than
+    // it was built from the same source
+    bool Compiler::binary_up_to_date() const {
+        std::error_code ec;
+        const auto binary_time = std::filesystem::last_write_time(output_file, ec);
+
+        if (ec) {
+            return false;
+        }
+
+        const auto source_time = std::filesystem::last_write_time(input_file, ec);
+        return !ec && binary_time > source_time;
+    }
+
     void Compiler::run_binary() {
         std::string command = "./" + output_file;
 
@@ -55,6 +69,15 @@ namespace compiler {
     }
 
     void Compiler::compile() {
+        if (binary_up_to_date()) {
+            std::cout << "Binary is up to date.\nExecuting..." << std::endl;
+            clear_screen();
+
+            std::cout << std::endl;
+            run_binary();
+            return;
+        }
+
         if (cmd_exists("gcc")) {
             compiler_type = "gcc";
             std::cout << "Compiling using gcc..." << std::endl;
@@ -0,0 +1,108 @@
+#ifndef IR_HPP
+#define IR_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ir {
+
+    // Index of an instruction, which is also the SSA value it defines
+    using ValueId = uint32_t;
+
+    enum Type : uint8_t {
+        VOID,
+        STRING,
+        FLOAT,
+        INTEGER
+    };
+
+    enum Opcode : uint8_t {
+        CONST,           // a: StringRope index, or the int/float bits
+        COPY,            // a: source
+        ADD,             // a, b: operands of the instruction's type
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        CONCAT,          // a, b: strings
+        INT_TO_FLOAT,    // a: int
+        INT_TO_STRING,   // a: int
+        FLOAT_TO_STRING, // a: float
+        PRINT,           // a: value, b: 1 for a trailing newline
+        WRITE            // a: StringRope index of output known up front
+    };
+
+    struct Instruction {
+        Opcode op;
+        Type type;
+        uint32_t a;
+        uint32_t b;
+    };
+
+    // Number of value operands op reads from a and b
+    int operand_count(Opcode op);
+
+    inline constexpr uint32_t flat_rope = UINT32_MAX;
+
+    // A constant string: either a flat piece (right == flat_rope, left
+    // indexes the pieces) or the concatenation of two earlier ropes.
+    // Folding a chain of concatenations only adds nodes, the bytes are
+    // copied once when the final value is flattened.
+    struct StringRope {
+        uint32_t left;
+        uint32_t right;
+        size_t length;
+    };
+
+    // A straight-line program in SSA form. Every instruction defines one
+    // value and only reads values defined before it, so instruction order
+    // is a valid evaluation order and a single forward sweep sees every
+    // definition before its uses.
+    class Function {
+        std::vector<Instruction> instructions;
+        std::vector<std::string> pieces;
+        std::vector<StringRope> ropes;
+
+    public:
+        // Ropes on their own, for passes building strings that no value
+        // holds yet
+        uint32_t add_piece(std::string value);
+        uint32_t concat(uint32_t left, uint32_t right);
+        [[nodiscard]] std::string flatten(uint32_t rope) const;
+        [[nodiscard]] size_t rope_length(uint32_t rope) const;
+
+        ValueId add(Opcode op, Type type, uint32_t a = 0, uint32_t b = 0);
+
+        ValueId add_string(std::string value);
+        ValueId add_float(float value);
+        ValueId add_integer(int value);
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] const Instruction& operator[](ValueId id) const;
+        Instruction& operator[](ValueId id);
+
+        [[nodiscard]] bool is_constant(ValueId id) const;
+        // Flattens the rope, linear in the string's length
+        [[nodiscard]] std::string string_value(ValueId id) const;
+        [[nodiscard]] size_t string_length(ValueId id) const;
+        [[nodiscard]] float float_value(ValueId id) const;
+        [[nodiscard]] int integer_value(ValueId id) const;
+
+        // Turn id into a constant in place, its uses stay valid
+        void make_string(ValueId id, std::string value);
+        // left and right must be string constants
+        void make_concat(ValueId id, ValueId left, ValueId right);
+        void make_write(ValueId id, uint32_t rope);
+        void make_float(ValueId id, float value);
+        void make_integer(ValueId id, int value);
+
+        // Drops every instruction with keep[id] false and renumbers the
+        // rest. Nothing kept may read a dropped value.
+        void compact(const std::vector<bool>& keep);
+    };
+
+}
+
+#endif //IR_HPP
@@ -0,0 +1,22 @@
+#ifndef IR_ERROR_HPP
+#define IR_ERROR_HPP
+
+#include <exception>
+#include <string>
+
+namespace ir {
+
+    class IRError final : public std::exception {
+        std::string message;
+
+        mutable std::string formatted_msg;
+
+    public:
+        explicit IRError(const std::string& msg);
+
+        const char* what() const noexcept override;
+    };
+
+}
+
+#endif //IR_ERROR_HPP
@@ -0,0 +1,73 @@
+#ifndef LOWERING_HPP
+#define LOWERING_HPP
+
+#include <utility>
+#include <vector>
+
+#include "ir.hpp"
+#include "statement_cache.hpp"
+#include "../../parser/include/ast_nodes.hpp"
+#include "../../sema/include/sema.hpp"
+
+namespace ir {
+
+    // Lowers a checked program to IR. A variable write becomes a COPY of
+    // the written value and every later read uses that COPY, so variables
+    // vanish and each value is defined exactly once.
+    class Lowering {
+        // A lowered expression node, epoch 0 if it reads no mutable variable
+        // and so stays valid for the whole program
+        struct LoweredNode {
+            ValueId value;
+            uint32_t epoch;
+        };
+
+        struct Operand {
+            ValueId value;
+            bool pure;
+        };
+
+        const parser::Program& program;
+        const sema::Annotations& annotations;
+        Function function;
+
+        // Latest value of each variable, by slot
+        std::vector<ValueId> variables;
+        // Value of each statement's expression
+        std::vector<ValueId> statement_values;
+
+        // Reuses shared subtrees of a hash consed program, bumping epoch
+        // on every mutable write retires the entries that read one
+        std::vector<LoweredNode> lowered;
+        uint32_t epoch = 1;
+
+        // Pending expression nodes, true once their operands are pushed
+        std::vector<std::pair<parser::NodeId, bool>> stack;
+        std::vector<Operand> operands;
+
+        Operand lower_leaf(parser::NodeId node);
+        ValueId convert(ValueId value, Type type);
+        ValueId lower_binary_op(parser::NodeId node, ValueId left, ValueId right);
+        ValueId lower_expr(parser::NodeId root);
+        ValueId lower_fragment(const Fragment& fragment);
+        ValueId lower_value(parser::NodeId value, const Fragment* reused);
+
+        void lower_write(parser::NodeId identifier, ValueId value);
+        void lower_builtin_func(parser::NodeId node, const Fragment* reused);
+        void lower_statement(parser::NodeId stmt, const Fragment* reused);
+
+    public:
+        // annotations come from sema::Sema on the very same program
+        Lowering(const parser::Program& program, const sema::Annotations& annotations);
+
+        // reused[i], when set, is statement i's value from an earlier run
+        // and stands in for its expression. Empty to lower everything.
+        Function lower(const std::vector<const Fragment*>& reused = {});
+
+        // Indexed by statement, valid until a pass renumbers the function
+        [[nodiscard]] const std::vector<ValueId>& values() const;
+    };
+
+}
+
+#endif //LOWERING_HPP
@@ -0,0 +1,24 @@
+#ifndef NUMBER_FORMAT_HPP
+#define NUMBER_FORMAT_HPP
+
+#include <array>
+#include <string_view>
+
+namespace ir {
+
+    // Large enough for anything written below, %f of FLT_MAX included
+    using NumberBuffer = std::array<char, 64>;
+
+    // Locale independent and allocation free, the result views into buffer
+
+    std::string_view format_integer(NumberBuffer& buffer, int value);
+
+    // How Cherry turns a float into text: printf's %f, six decimals
+    std::string_view format_float(NumberBuffer& buffer, float value);
+
+    // Fewest digits that still read back as exactly value
+    std::string_view format_float_shortest(NumberBuffer& buffer, float value);
+
+}
+
+#endif //NUMBER_FORMAT_HPP
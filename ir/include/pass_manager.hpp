@@ -0,0 +1,38 @@
+#ifndef PASS_MANAGER_HPP
+#define PASS_MANAGER_HPP
+
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "ir.hpp"
+
+namespace ir {
+
+    using PassFunction = std::function<void(Function& function)>;
+
+    struct PassTiming {
+        std::string_view name;
+        std::chrono::nanoseconds elapsed;
+    };
+
+    // Runs named passes over a function in the order they were added
+    class PassManager {
+        struct Pass {
+            std::string_view name;
+            PassFunction run;
+        };
+
+        std::vector<Pass> passes;
+
+    public:
+        void add(std::string_view name, PassFunction run);
+
+        // One timing per pass, in run order
+        std::vector<PassTiming> run(Function& function) const;
+    };
+
+}
+
+#endif //PASS_MANAGER_HPP
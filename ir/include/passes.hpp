@@ -0,0 +1,25 @@
+#ifndef PASSES_HPP
+#define PASSES_HPP
+
+#include "ir.hpp"
+
+namespace ir {
+
+    // Points every use of a COPY at the copied value, leaving the COPY dead
+    void propagate_copies(Function& function);
+
+    // Replaces instructions whose operands are all constants with their
+    // result. Throws IRError on integer division by zero.
+    void fold_constants(Function& function);
+
+    // Partial evaluation of the program's output: every run of PRINTs
+    // of constants becomes one WRITE of the text they would print. A
+    // fully static program ends up as a single WRITE.
+    void precompute_output(Function& function);
+
+    // Drops every instruction no PRINT or WRITE depends on
+    void eliminate_dead_code(Function& function);
+
+}
+
+#endif //PASSES_HPP
@@ -0,0 +1,70 @@
+#ifndef STATEMENT_CACHE_HPP
+#define STATEMENT_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ir.hpp"
+#include "statement_graph.hpp"
+
+namespace ir {
+
+    // The folded value of a statement's expression: the variable's value
+    // for a write, what gets printed for a builtin
+    struct Fragment {
+        Type type;
+        uint32_t bits;         // INTEGER, FLOAT
+        std::string_view text; // STRING
+    };
+
+    // On disk, text is an offset into the file's text bytes
+    struct StoredFragment {
+        uint64_t fingerprint;
+        uint32_t bits;
+        uint32_t text_offset;
+        uint32_t text_length;
+        uint32_t type;
+    };
+
+    // Fragments of the last run over a launch file, keyed by statement
+    // fingerprint. A statement whose fingerprint has a fragment is lowered
+    // straight to that constant, skipping its expression.
+    class StatementCache {
+        std::string path;
+
+        // The last run's, as loaded. Looked up through an open addressing
+        // index over a power-of-two bucket array kept at most half full.
+        std::vector<Fragment> previous;
+        std::vector<uint64_t> previous_fingerprints;
+        std::vector<uint32_t> buckets;
+        std::string previous_text;
+
+        // This run's, written out by store
+        std::vector<StoredFragment> recorded;
+        std::string recorded_text;
+
+        void index_previous();
+
+    public:
+        // Loads the entry for source_path from directory, a missing or
+        // unreadable one just means nothing is reused
+        StatementCache(const std::string& directory, std::string_view source_path);
+
+        // nullptr unless the last run left a fragment for fingerprint. Valid
+        // as long as the cache is.
+        [[nodiscard]] const Fragment* find(uint64_t fingerprint) const;
+
+        // Takes the value of every statement that folded to a constant.
+        // values[i] is the ValueId lowering gave statement i.
+        void record(const StatementGraph& graph, const std::vector<ValueId>& values, const Function& function);
+
+        // Replaces the entry with this run's fragments. Failing to write is
+        // not an error, the next run just reuses nothing.
+        void store() const;
+    };
+
+}
+
+#endif //STATEMENT_CACHE_HPP
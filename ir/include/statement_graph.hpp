@@ -0,0 +1,30 @@
+#ifndef STATEMENT_GRAPH_HPP
+#define STATEMENT_GRAPH_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "../../parser/include/ast_nodes.hpp"
+#include "../../sema/include/sema.hpp"
+
+namespace ir {
+
+    // A fingerprint per statement, hashing its own source together with
+    // the fingerprints of the earlier statements whose writes it reads. It
+    // changes exactly when the statement or anything it transitively reads
+    // changes. The dependency edges themselves are only walked, not kept.
+    class StatementGraph {
+        std::vector<uint64_t> fingerprints;
+
+    public:
+        // annotations come from sema::Sema on the very same program
+        StatementGraph(const parser::Program& program, const sema::Annotations& annotations);
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] uint64_t fingerprint(uint32_t stmt) const;
+    };
+
+}
+
+#endif //STATEMENT_GRAPH_HPP
@@ -0,0 +1,165 @@
+#include "../include/ir.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace ir {
+
+    int operand_count(const Opcode op) {
+        switch (op) {
+            case CONST:
+            case WRITE: return 0;
+            case COPY:
+            case INT_TO_FLOAT:
+            case INT_TO_STRING:
+            case FLOAT_TO_STRING:
+            case PRINT: return 1;
+            case ADD:
+            case SUBTRACT:
+            case MULTIPLY:
+            case DIVIDE:
+            case CONCAT: return 2;
+        }
+
+        return 0;
+    }
+
+    ValueId Function::add(const Opcode op, const Type type, const uint32_t a, const uint32_t b) {
+        instructions.push_back({ op, type, a, b });
+        return static_cast<ValueId>(instructions.size() - 1);
+    }
+
+    uint32_t Function::add_piece(std::string value) {
+        const size_t length = value.length();
+
+        pieces.push_back(std::move(value));
+        ropes.push_back({ static_cast<uint32_t>(pieces.size() - 1), flat_rope, length });
+
+        return static_cast<uint32_t>(ropes.size() - 1);
+    }
+
+    uint32_t Function::concat(const uint32_t left, const uint32_t right) {
+        ropes.push_back({ left, right, ropes[left].length + ropes[right].length });
+        return static_cast<uint32_t>(ropes.size() - 1);
+    }
+
+    std::string Function::flatten(const uint32_t rope) const {
+        std::string result;
+        result.reserve(ropes[rope].length);
+
+        // Left to right over the leaves, an explicit stack since chains
+        // from the folder lean deep to one side
+        std::vector<uint32_t> stack{ rope };
+
+        while (!stack.empty()) {
+            const StringRope& current = ropes[stack.back()];
+            stack.pop_back();
+
+            if (current.right == flat_rope) {
+                result += pieces[current.left];
+            } else {
+                stack.push_back(current.right);
+                stack.push_back(current.left);
+            }
+        }
+
+        return result;
+    }
+
+    size_t Function::rope_length(const uint32_t rope) const {
+        return ropes[rope].length;
+    }
+
+    ValueId Function::add_string(std::string value) {
+        return add(CONST, STRING, add_piece(std::move(value)));
+    }
+
+    ValueId Function::add_float(const float value) {
+        return add(CONST, FLOAT, std::bit_cast<uint32_t>(value));
+    }
+
+    ValueId Function::add_integer(const int value) {
+        return add(CONST, INTEGER, static_cast<uint32_t>(value));
+    }
+
+    size_t Function::size() const {
+        return instructions.size();
+    }
+
+    const Instruction& Function::operator[](const ValueId id) const {
+        return instructions[id];
+    }
+
+    Instruction& Function::operator[](const ValueId id) {
+        return instructions[id];
+    }
+
+    bool Function::is_constant(const ValueId id) const {
+        return instructions[id].op == CONST;
+    }
+
+    std::string Function::string_value(const ValueId id) const {
+        assert(is_constant(id) && instructions[id].type == STRING);
+        return flatten(instructions[id].a);
+    }
+
+    size_t Function::string_length(const ValueId id) const {
+        assert(is_constant(id) && instructions[id].type == STRING);
+        return rope_length(instructions[id].a);
+    }
+
+    float Function::float_value(const ValueId id) const {
+        assert(is_constant(id) && instructions[id].type == FLOAT);
+        return std::bit_cast<float>(instructions[id].a);
+    }
+
+    int Function::integer_value(const ValueId id) const {
+        assert(is_constant(id) && instructions[id].type == INTEGER);
+        return static_cast<int>(instructions[id].a);
+    }
+
+    void Function::make_string(const ValueId id, std::string value) {
+        instructions[id] = { CONST, STRING, add_piece(std::move(value)), 0 };
+    }
+
+    void Function::make_concat(const ValueId id, const ValueId left, const ValueId right) {
+        instructions[id] = { CONST, STRING, concat(instructions[left].a, instructions[right].a), 0 };
+    }
+
+    void Function::make_write(const ValueId id, const uint32_t rope) {
+        instructions[id] = { WRITE, VOID, rope, 0 };
+    }
+
+    void Function::make_float(const ValueId id, const float value) {
+        instructions[id] = { CONST, FLOAT, std::bit_cast<uint32_t>(value), 0 };
+    }
+
+    void Function::make_integer(const ValueId id, const int value) {
+        instructions[id] = { CONST, INTEGER, static_cast<uint32_t>(value), 0 };
+    }
+
+    void Function::compact(const std::vector<bool>& keep) {
+        // Operands always point backwards, so one forward sweep can rename
+        // them as it goes
+        std::vector<ValueId> renamed(instructions.size());
+        ValueId next = 0;
+
+        for (ValueId id = 0; id < instructions.size(); id++) {
+            if (!keep[id]) {
+                continue;
+            }
+
+            Instruction inst = instructions[id];
+            const int operands = operand_count(inst.op);
+
+            if (operands > 0) inst.a = renamed[inst.a];
+            if (operands > 1) inst.b = renamed[inst.b];
+
+            renamed[id] = next;
+            instructions[next++] = inst;
+        }
+
+        instructions.resize(next);
+    }
+
+}
@@ -0,0 +1,14 @@
+#include "../include/ir_error.hpp"
+
+namespace ir {
+
+    IRError::IRError(const std::string& msg) {
+        this->message = msg;
+    }
+
+    const char* IRError::what() const noexcept {
+        formatted_msg = "Error: " + message;
+        return formatted_msg.c_str();
+    }
+
+}
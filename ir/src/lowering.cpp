@@ -0,0 +1,248 @@
+#include "../include/lowering.hpp"
+
+#include "../include/ir_error.hpp"
+#include "../../parser/include/ast_visitor.hpp"
+
+namespace ir {
+
+    static Type type_of(const parser::ASTValueType type) {
+        switch (type) {
+            case parser::STRING_LITERAL: return STRING;
+            case parser::FLOAT: return FLOAT;
+            case parser::INTEGER: return INTEGER;
+            default:
+                throw IRError("Expression of type '" + parser::ast_val_type_str(type) + "' has no value.");
+        }
+    }
+
+    static Opcode opcode_of(const parser::BinaryOperator op) {
+        switch (op) {
+            case parser::ADD: return ADD;
+            case parser::SUBTRACT: return SUBTRACT;
+            case parser::MULTIPLY: return MULTIPLY;
+            case parser::DIVIDE: return DIVIDE;
+        }
+
+        throw IRError("Unsupported binary operator.");
+    }
+
+    static int octal_digit(const char c) {
+        return c >= '0' && c <= '7' ? c - '0' : -1;
+    }
+
+    static int hex_digit(const char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Literals keep C's escapes as written, IR strings hold the bytes they
+    // stand for, so joining two strings can never merge their escapes
+    static std::string decode_escapes(const std::string_view text) {
+        std::string bytes;
+        bytes.reserve(text.length());
+
+        for (size_t i = 0; i < text.length(); i++) {
+            if (text[i] != '\\' || i + 1 == text.length()) {
+                bytes += text[i];
+                continue;
+            }
+
+            const char c = text[++i];
+
+            switch (c) {
+                case 'n': bytes += '\n'; break;
+                case 't': bytes += '\t'; break;
+                case 'r': bytes += '\r'; break;
+                case 'a': bytes += '\a'; break;
+                case 'b': bytes += '\b'; break;
+                case 'f': bytes += '\f'; break;
+                case 'v': bytes += '\v'; break;
+                case 'x': {
+                    unsigned value = 0;
+                    size_t digits = 0;
+
+                    while (i + 1 < text.length() && hex_digit(text[i + 1]) >= 0) {
+                        value = value * 16 + hex_digit(text[++i]);
+                        digits++;
+                    }
+
+                    bytes += digits ? static_cast<char>(value) : 'x';
+                } break;
+                default: {
+                    if (octal_digit(c) < 0) {
+                        // \\, \', \? and unknown escapes are the character itself
+                        bytes += c;
+                        break;
+                    }
+
+                    unsigned value = octal_digit(c);
+
+                    for (int digits = 1; digits < 3 && i + 1 < text.length() && octal_digit(text[i + 1]) >= 0; digits++) {
+                        value = value * 8 + octal_digit(text[++i]);
+                    }
+
+                    bytes += static_cast<char>(value);
+                }
+            }
+        }
+
+        return bytes;
+    }
+
+    Lowering::Lowering(const parser::Program& program, const sema::Annotations& annotations)
+        : program(program), annotations(annotations) {}
+
+    Lowering::Operand Lowering::lower_leaf(const parser::NodeId node) {
+        return parser::visit(program, node, parser::overloaded{
+            [&](const parser::Identifier& identifier) -> Operand {
+                return {
+                    variables[annotations.slot(identifier.id)],
+                    !annotations.symbol(identifier.id).muttable
+                };
+            },
+            [&](const parser::StringLiteral& literal) -> Operand {
+                return { function.add_string(decode_escapes(literal.content)), true };
+            },
+            [&](const parser::Float& literal) -> Operand { return { function.add_float(literal.value), true }; },
+            [&](const parser::Integer& literal) -> Operand { return { function.add_integer(literal.value), true }; },
+            [](const auto&) -> Operand { throw IRError("Invalid AST for value."); }
+        });
+    }
+
+    ValueId Lowering::convert(const ValueId value, const Type type) {
+        const Type from = function[value].type;
+
+        if (from == type) {
+            return value;
+        }
+
+        if (type == STRING) {
+            return function.add(from == INTEGER ? INT_TO_STRING : FLOAT_TO_STRING, STRING, value);
+        }
+
+        return function.add(INT_TO_FLOAT, FLOAT, value);
+    }
+
+    ValueId Lowering::lower_binary_op(const parser::NodeId node, const ValueId left, const ValueId right) {
+        // Sema only lets ADD through for strings, and int operands meet a
+        // float one as float
+        const Type type = type_of(annotations.type(node));
+        const Opcode op = type == STRING ? CONCAT : opcode_of(program.op(node));
+
+        return function.add(op, type, convert(left, type), convert(right, type));
+    }
+
+    ValueId Lowering::lower_expr(const parser::NodeId root) {
+        stack.clear();
+        operands.clear();
+        stack.emplace_back(root, false);
+
+        while (!stack.empty()) {
+            const auto [current, expanded] = stack.back();
+            stack.pop_back();
+
+            if (program.type(current) != parser::BINARY_OP) {
+                operands.push_back(lower_leaf(current));
+                continue;
+            }
+
+            if (current < lowered.size() && lowered[current].epoch != UINT32_MAX) {
+                const LoweredNode& cached = lowered[current];
+
+                if (cached.epoch == 0 || cached.epoch == epoch) {
+                    operands.push_back({ cached.value, cached.epoch == 0 });
+                    continue;
+                }
+            }
+
+            if (!expanded) {
+                stack.emplace_back(current, true);
+                stack.emplace_back(program.right(current), false);
+                stack.emplace_back(program.left(current), false);
+                continue;
+            }
+
+            const Operand right = operands.back();
+            operands.pop_back();
+            const Operand left = operands.back();
+            operands.pop_back();
+
+            const Operand result{
+                lower_binary_op(current, left.value, right.value),
+                left.pure && right.pure
+            };
+
+            if (current >= lowered.size()) {
+                lowered.resize(current + 1, { 0, UINT32_MAX });
+            }
+
+            lowered[current] = { result.value, result.pure ? 0 : epoch };
+            operands.push_back(result);
+        }
+
+        return operands.back().value;
+    }
+
+    ValueId Lowering::lower_fragment(const Fragment& fragment) {
+        if (fragment.type == STRING) {
+            return function.add_string(std::string(fragment.text));
+        }
+
+        return function.add(CONST, fragment.type, fragment.bits);
+    }
+
+    ValueId Lowering::lower_value(const parser::NodeId value, const Fragment* reused) {
+        const ValueId result = reused ? lower_fragment(*reused) : lower_expr(value);
+
+        statement_values.push_back(result);
+        return result;
+    }
+
+    void Lowering::lower_write(const parser::NodeId identifier, const ValueId value) {
+        variables[annotations.slot(identifier)] = function.add(COPY, function[value].type, value);
+
+        if (annotations.symbol(identifier).muttable) {
+            epoch++;
+        }
+    }
+
+    void Lowering::lower_builtin_func(const parser::NodeId node, const Fragment* reused) {
+        const lexer::DefinedFunction func = program.func(node);
+
+        if (func != lexer::PRINT && func != lexer::PRINTLN) {
+            throw IRError("Unsupported function '" + std::string(lexer::defined_function_name(func)) + "!'.");
+        }
+
+        function.add(PRINT, VOID, lower_value(program.arg(node), reused), func == lexer::PRINTLN);
+    }
+
+    void Lowering::lower_statement(const parser::NodeId stmt, const Fragment* reused) {
+        parser::visit(program, stmt, parser::overloaded{
+            [&](const parser::ImmDeclare& node) { lower_write(node.identifier, lower_value(node.value, reused)); },
+            [&](const parser::MutDeclare& node) { lower_write(node.identifier, lower_value(node.value, reused)); },
+            [&](const parser::AssignVar& node) { lower_write(node.identifier, lower_value(node.value, reused)); },
+            [&](const parser::BuiltInFunc& node) { lower_builtin_func(node.id, reused); },
+            [](const auto&) { throw IRError("Unidentified statement AST."); }
+        });
+    }
+
+    Function Lowering::lower(const std::vector<const Fragment*>& reused) {
+        const std::vector<parser::NodeId>& stmts = program.get_statements();
+
+        variables.assign(annotations.symbol_table().size(), 0);
+        statement_values.reserve(stmts.size());
+
+        for (size_t i = 0; i < stmts.size(); i++) {
+            lower_statement(stmts[i], i < reused.size() ? reused[i] : nullptr);
+        }
+
+        return std::move(function);
+    }
+
+    const std::vector<ValueId>& Lowering::values() const {
+        return statement_values;
+    }
+
+}
@@ -0,0 +1,24 @@
+#include "../include/number_format.hpp"
+
+#include <charconv>
+
+namespace ir {
+
+    std::string_view format_integer(NumberBuffer& buffer, const int value) {
+        const auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        return { buffer.data(), end };
+    }
+
+    std::string_view format_float(NumberBuffer& buffer, const float value) {
+        const auto [end, ec] = std::to_chars(
+            buffer.data(), buffer.data() + buffer.size(), value, std::chars_format::fixed, 6
+        );
+        return { buffer.data(), end };
+    }
+
+    std::string_view format_float_shortest(NumberBuffer& buffer, const float value) {
+        const auto [end, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        return { buffer.data(), end };
+    }
+
+}
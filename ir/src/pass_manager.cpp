@@ -0,0 +1,22 @@
+#include "../include/pass_manager.hpp"
+
+namespace ir {
+
+    void PassManager::add(const std::string_view name, PassFunction run) {
+        passes.push_back({ name, std::move(run) });
+    }
+
+    std::vector<PassTiming> PassManager::run(Function& function) const {
+        std::vector<PassTiming> timings;
+        timings.reserve(passes.size());
+
+        for (const Pass& pass : passes) {
+            const auto start = std::chrono::steady_clock::now();
+            pass.run(function);
+            timings.push_back({ pass.name, std::chrono::steady_clock::now() - start });
+        }
+
+        return timings;
+    }
+
+}
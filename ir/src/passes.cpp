@@ -0,0 +1,172 @@
+#include "../include/passes.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "../include/ir_error.hpp"
+#include "../include/number_format.hpp"
+
+namespace ir {
+
+    void propagate_copies(Function& function) {
+        // Sources are resolved before their uses, so chains of copies
+        // collapse in one sweep
+        for (ValueId id = 0; id < function.size(); id++) {
+            Instruction& inst = function[id];
+            const int operands = operand_count(inst.op);
+
+            if (operands > 0 && function[inst.a].op == COPY) inst.a = function[inst.a].a;
+            if (operands > 1 && function[inst.b].op == COPY) inst.b = function[inst.b].a;
+        }
+    }
+
+    static std::string number_str(const Function& function, const ValueId id) {
+        NumberBuffer buffer;
+
+        if (function[id].type == FLOAT) {
+            return std::string(format_float(buffer, function.float_value(id)));
+        }
+
+        return std::string(format_integer(buffer, function.integer_value(id)));
+    }
+
+    static void fold_arithmetic(Function& function, const ValueId id) {
+        const Instruction inst = function[id];
+
+        if (inst.type == FLOAT) {
+            const float l = function.float_value(inst.a);
+            const float r = function.float_value(inst.b);
+
+            switch (inst.op) {
+                case ADD: function.make_float(id, l + r); break;
+                case SUBTRACT: function.make_float(id, l - r); break;
+                case MULTIPLY: function.make_float(id, l * r); break;
+                case DIVIDE: function.make_float(id, l / r); break;
+                default: break;
+            }
+
+            return;
+        }
+
+        // Wide enough that no int operation overflows, including INT_MIN / -1
+        const int64_t l = function.integer_value(inst.a);
+        const int64_t r = function.integer_value(inst.b);
+        int64_t result = 0;
+
+        switch (inst.op) {
+            case ADD: result = l + r; break;
+            case SUBTRACT: result = l - r; break;
+            case MULTIPLY: result = l * r; break;
+            case DIVIDE: {
+                if (r == 0) {
+                    throw IRError("Integer division by zero in constant expression.");
+                }
+
+                result = l / r;
+            } break;
+            default: return;
+        }
+
+        if (result < std::numeric_limits<int>::min() || result > std::numeric_limits<int>::max()) {
+            throw IRError("Integer overflow in constant expression.");
+        }
+
+        function.make_integer(id, static_cast<int>(result));
+    }
+
+    void fold_constants(Function& function) {
+        for (ValueId id = 0; id < function.size(); id++) {
+            const Instruction inst = function[id];
+            const int operands = operand_count(inst.op);
+
+            if (inst.op == PRINT || operands == 0) {
+                continue;
+            }
+
+            if (!function.is_constant(inst.a) || (operands > 1 && !function.is_constant(inst.b))) {
+                continue;
+            }
+
+            switch (inst.op) {
+                case COPY: function[id] = function[inst.a]; break;
+                case ADD:
+                case SUBTRACT:
+                case MULTIPLY:
+                case DIVIDE: fold_arithmetic(function, id); break;
+                case CONCAT: function.make_concat(id, inst.a, inst.b); break;
+                case INT_TO_FLOAT: function.make_float(id, static_cast<float>(function.integer_value(inst.a))); break;
+                case INT_TO_STRING:
+                case FLOAT_TO_STRING: function.make_string(id, number_str(function, inst.a)); break;
+                default: break;
+            }
+        }
+    }
+
+    void precompute_output(Function& function) {
+        std::vector<bool> keep(function.size(), true);
+        const uint32_t newline = function.add_piece("\n");
+        // Last WRITE of the current run, values defined in between have
+        // no side effects so a run only ends at a PRINT of a runtime value
+        ValueId run_end = 0;
+        bool in_run = false;
+
+        for (ValueId id = 0; id < function.size(); id++) {
+            const Instruction inst = function[id];
+
+            if (inst.op != PRINT) {
+                continue;
+            }
+
+            if (!function.is_constant(inst.a)) {
+                in_run = false;
+                continue;
+            }
+
+            uint32_t text = function[inst.a].type == STRING
+                ? function[inst.a].a
+                : function.add_piece(number_str(function, inst.a));
+
+            if (inst.b) {
+                text = function.concat(text, newline);
+            }
+
+            if (in_run) {
+                keep[run_end] = false;
+                text = function.concat(function[run_end].a, text);
+            }
+
+            function.make_write(id, text);
+            run_end = id;
+            in_run = true;
+        }
+
+        function.compact(keep);
+    }
+
+    void eliminate_dead_code(Function& function) {
+        std::vector<bool> live(function.size(), false);
+
+        // Uses come after definitions, so walking backwards marks a value
+        // before anything it reads is visited
+        for (ValueId id = static_cast<ValueId>(function.size()); id-- > 0;) {
+            const Instruction& inst = function[id];
+
+            if (inst.op == PRINT || inst.op == WRITE) {
+                live[id] = true;
+            }
+
+            if (!live[id]) {
+                continue;
+            }
+
+            const int operands = operand_count(inst.op);
+
+            if (operands > 0) live[inst.a] = true;
+            if (operands > 1) live[inst.b] = true;
+        }
+
+        function.compact(live);
+    }
+
+}
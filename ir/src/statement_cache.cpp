@@ -0,0 +1,163 @@
+#include "../include/statement_cache.hpp"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+#include "../../cache/include/cache_file.hpp"
+#include "../../cache/include/hash.hpp"
+
+namespace ir {
+
+    // Bump the version whenever StoredFragment, Type or the layout below changes
+    static constexpr cache::EntryTag statement_cache_tag = { { 'C', 'H', 'S', 'C' }, 3 };
+
+    static constexpr uint32_t empty_bucket = UINT32_MAX;
+
+    // Longer strings are refolded every run, storing each step of a long
+    // concatenation chain would take space quadratic in its length
+    static constexpr size_t max_fragment_text = 1 << 12;
+
+    static_assert(std::is_trivially_copyable_v<StoredFragment> && sizeof(StoredFragment) == 24);
+
+    // File layout, every section follows the previous one unpadded:
+    //   StatementCacheHeader
+    //   StoredFragment[fragment_count]
+    //   char[text_bytes]
+    struct StatementCacheHeader {
+        cache::EntryHeader entry;
+        uint32_t fragment_count;
+        uint32_t text_bytes;
+    };
+
+    // Only values a statement can fold to, anything else is corruption
+    static bool valid_entry(const StoredFragment& entry, const size_t text_bytes) {
+        if (entry.type != STRING && entry.type != FLOAT && entry.type != INTEGER) {
+            return false;
+        }
+
+        return static_cast<size_t>(entry.text_offset) + entry.text_length <= text_bytes;
+    }
+
+    StatementCache::StatementCache(const std::string& directory, const std::string_view source_path) {
+        this->path = cache::entry_path(directory, cache::hash_bytes(source_path), ".stmt");
+
+        StatementCacheHeader header{};
+        const auto file = cache::open_entry(path, statement_cache_tag, &header, sizeof(header));
+
+        if (!file) {
+            return;
+        }
+
+        const std::string_view bytes = file->view();
+        const size_t expected_size = sizeof(header) +
+            static_cast<size_t>(header.fragment_count) * sizeof(StoredFragment) +
+            header.text_bytes;
+
+        if (bytes.length() != expected_size) {
+            return;
+        }
+
+        std::vector<StoredFragment> stored(header.fragment_count);
+        std::memcpy(stored.data(), bytes.data() + sizeof(header), stored.size() * sizeof(StoredFragment));
+
+        previous_text.assign(bytes.substr(bytes.length() - header.text_bytes));
+        previous.reserve(stored.size());
+        previous_fingerprints.reserve(stored.size());
+
+        for (const StoredFragment& entry : stored) {
+            if (!valid_entry(entry, previous_text.length())) {
+                previous.clear();
+                previous_fingerprints.clear();
+                return;
+            }
+
+            previous.push_back({
+                static_cast<Type>(entry.type),
+                entry.bits,
+                std::string_view(previous_text).substr(entry.text_offset, entry.text_length)
+            });
+            previous_fingerprints.push_back(entry.fingerprint);
+        }
+
+        index_previous();
+    }
+
+    void StatementCache::index_previous() {
+        buckets.assign(std::bit_ceil(previous.size() * 2 + 1), empty_bucket);
+        const size_t mask = buckets.size() - 1;
+
+        for (uint32_t i = 0; i < previous.size(); i++) {
+            size_t bucket = previous_fingerprints[i] & mask;
+
+            // The same statement written twice has one fingerprint, first wins
+            while (buckets[bucket] != empty_bucket && previous_fingerprints[buckets[bucket]] != previous_fingerprints[i]) {
+                bucket = (bucket + 1) & mask;
+            }
+
+            if (buckets[bucket] == empty_bucket) {
+                buckets[bucket] = i;
+            }
+        }
+    }
+
+    const Fragment* StatementCache::find(const uint64_t fingerprint) const {
+        if (buckets.empty()) {
+            return nullptr;
+        }
+
+        const size_t mask = buckets.size() - 1;
+
+        // Fingerprints are already well mixed hashes
+        for (size_t bucket = fingerprint & mask; buckets[bucket] != empty_bucket; bucket = (bucket + 1) & mask) {
+            if (previous_fingerprints[buckets[bucket]] == fingerprint) {
+                return &previous[buckets[bucket]];
+            }
+        }
+
+        return nullptr;
+    }
+
+    void StatementCache::record(const StatementGraph& graph, const std::vector<ValueId>& values, const Function& function) {
+        recorded.reserve(graph.size());
+
+        for (uint32_t stmt = 0; stmt < graph.size(); stmt++) {
+            const ValueId value = values[stmt];
+
+            if (!function.is_constant(value)) {
+                continue;
+            }
+
+            const Instruction& inst = function[value];
+            StoredFragment entry{ graph.fingerprint(stmt), inst.a, 0, 0, inst.type };
+
+            if (inst.type == STRING) {
+                if (function.string_length(value) > max_fragment_text) {
+                    continue;
+                }
+
+                const std::string text = function.string_value(value);
+
+                entry.bits = 0;
+                entry.text_offset = static_cast<uint32_t>(recorded_text.length());
+                entry.text_length = static_cast<uint32_t>(text.length());
+                recorded_text += text;
+            }
+
+            recorded.push_back(entry);
+        }
+    }
+
+    void StatementCache::store() const {
+        StatementCacheHeader header{};
+        header.entry.tag = statement_cache_tag;
+        header.fragment_count = static_cast<uint32_t>(recorded.size());
+        header.text_bytes = static_cast<uint32_t>(recorded_text.length());
+
+        cache::write_entry(path, &header, sizeof(header), {
+            { recorded.data(), recorded.size() * sizeof(StoredFragment) },
+            { recorded_text.data(), recorded_text.length() }
+        });
+    }
+
+}
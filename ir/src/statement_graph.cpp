@@ -0,0 +1,122 @@
+#include "../include/statement_graph.hpp"
+
+#include <bit>
+
+#include "../../cache/include/hash.hpp"
+
+namespace ir {
+
+    static uint64_t mix(const uint64_t h, const uint64_t value) {
+        return (h ^ (value + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2))) * 0x100000001B3ull;
+    }
+
+    // Hashes of every node's subtree, in one sweep since children always
+    // come before their parents. Identifiers hash their spelling, SymbolIds
+    // depend on where in the file a name first appears.
+    static std::vector<uint64_t> hash_nodes(const parser::Program& program) {
+        std::vector<uint64_t> hashes(program.size());
+
+        for (parser::NodeId id = 0; id < program.size(); id++) {
+            const parser::ASTValueType type = program.type(id);
+            uint64_t h = mix(0, type);
+
+            switch (type) {
+                case parser::STRING_LITERAL:
+                    h = mix(h, cache::hash_bytes(program.string_value(id)));
+                    break;
+                case parser::FLOAT:
+                    h = mix(h, std::bit_cast<uint32_t>(program.float_value(id)));
+                    break;
+                case parser::INTEGER:
+                    h = mix(h, static_cast<uint32_t>(program.integer_value(id)));
+                    break;
+                case parser::IDENTIFIER:
+                    h = mix(h, cache::hash_bytes(lexer::symbol_name(program.symbol(id))));
+                    break;
+                case parser::BUILTIN_FUNC:
+                    h = mix(mix(h, program.func(id)), hashes[program.arg(id)]);
+                    break;
+                case parser::IMM_DECLARE:
+                case parser::MUT_DECLARE:
+                case parser::ASSIGN_VAR:
+                    h = mix(mix(h, hashes[program.identifier(id)]), hashes[program.value(id)]);
+                    break;
+                case parser::BINARY_OP:
+                    h = mix(mix(mix(h, program.op(id)), hashes[program.left(id)]), hashes[program.right(id)]);
+                    break;
+            }
+
+            hashes[id] = h;
+        }
+
+        return hashes;
+    }
+
+    StatementGraph::StatementGraph(const parser::Program& program, const sema::Annotations& annotations) {
+        const std::vector<parser::NodeId>& stmts = program.get_statements();
+        const std::vector<uint64_t> hashes = hash_nodes(program);
+
+        // Statement holding the latest write of each slot
+        std::vector<uint32_t> writer(annotations.symbol_table().size(), 0);
+
+        // Stamped per statement, so shared subtrees and repeated reads of a
+        // variable are only looked at once
+        std::vector<uint32_t> node_stamp(program.size(), 0);
+        std::vector<uint32_t> slot_stamp(writer.size(), 0);
+        std::vector<parser::NodeId> stack;
+
+        fingerprints.reserve(stmts.size());
+
+        for (uint32_t i = 0; i < stmts.size(); i++) {
+            const parser::NodeId stmt = stmts[i];
+            const uint32_t stamp = i + 1;
+            uint64_t fingerprint = hashes[stmt];
+            sema::SlotId write = sema::no_slot;
+
+            if (program.type(stmt) == parser::BUILTIN_FUNC) {
+                stack.push_back(program.arg(stmt));
+            } else {
+                write = annotations.slot(program.identifier(stmt));
+                stack.push_back(program.value(stmt));
+            }
+
+            while (!stack.empty()) {
+                const parser::NodeId node = stack.back();
+                stack.pop_back();
+
+                if (node_stamp[node] == stamp) {
+                    continue;
+                }
+
+                node_stamp[node] = stamp;
+
+                if (program.type(node) == parser::BINARY_OP) {
+                    stack.push_back(program.left(node));
+                    stack.push_back(program.right(node));
+                } else if (program.type(node) == parser::IDENTIFIER) {
+                    const sema::SlotId slot = annotations.slot(node);
+
+                    if (slot_stamp[slot] != stamp) {
+                        slot_stamp[slot] = stamp;
+                        fingerprint = mix(fingerprint, fingerprints[writer[slot]]);
+                    }
+                }
+            }
+
+            fingerprints.push_back(fingerprint);
+
+            if (write != sema::no_slot) {
+                writer[write] = i;
+            }
+        }
+    }
+
+    size_t StatementGraph::size() const {
+        return fingerprints.size();
+    }
+
+    uint64_t StatementGraph::fingerprint(const uint32_t stmt) const {
+        return fingerprints[stmt];
+    }
+
+}
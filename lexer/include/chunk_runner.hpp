@@ -0,0 +1,32 @@
+#ifndef CHUNK_RUNNER_HPP
+#define CHUNK_RUNNER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace lexer {
+
+    // How many chunks to split size units of work into: one per
+    // min_chunk_size units, at least one and at most one per core
+    size_t chunk_count(size_t size, size_t min_chunk_size);
+
+    // Splits [begin, end) into up to count ranges of similar size, returned
+    // as count + 1 bounds. Every inner bound is one past the separator that
+    // find_separator returns at or after its target, and splitting stops at
+    // the first search that returns end or beyond.
+    std::vector<size_t> chunk_bounds(
+        size_t begin,
+        size_t end,
+        size_t count,
+        const std::function<size_t(size_t target)>& find_separator
+    );
+
+    // Calls run_chunk(i) for every range of bounds, each on its own thread,
+    // and waits for all of them. Chunks are in source order, so the first
+    // chunk that threw holds the first error, and that one is rethrown.
+    void run_chunks(const std::vector<size_t>& bounds, const std::function<void(size_t chunk)>& run_chunk);
+
+}
+
+#endif //CHUNK_RUNNER_HPP
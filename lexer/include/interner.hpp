@@ -0,0 +1,20 @@
+#ifndef INTERNER_HPP
+#define INTERNER_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace lexer {
+
+    // Dense id for an interned identifier or builtin name. Ids are handed out
+    // in first-seen order and stay valid for the rest of the compile. Safe to
+    // call from several lexer threads at once.
+    using SymbolId = uint32_t;
+
+    SymbolId intern(std::string_view name);
+
+    std::string_view symbol_name(SymbolId id);
+
+}
+
+#endif //INTERNER_HPP
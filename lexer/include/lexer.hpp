@@ -1,35 +1,72 @@
 #ifndef LEXER_HPP
 #define LEXER_HPP
 
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "source_buffer.hpp"
 #include "token.hpp"
 
 namespace lexer {
 
+    // A run of changed lines: old_line_count lines starting at first_line in
+    // the previous source were replaced by new_line_count lines.
+    struct LineEdit {
+        uint32_t first_line;
+        uint32_t old_line_count;
+        uint32_t new_line_count;
+    };
+
     class Lexer {
         std::string file_name;
-        std::string current_source;
-        int line;
-        int index;
+        std::unique_ptr<SourceBuffer> source;
+        std::string_view buffer;
+        std::string_view current_source;
+        uint32_t line_start;
+        size_t cursor;
+        std::unordered_map<std::string_view, SymbolId> symbol_cache;
 
         char peek() const;
-        char consume();
+        std::string_view rest() const;
+        uint32_t offset() const;
+        SymbolId intern_word(std::string_view word);
+
+        [[noreturn]] void error(const std::string& msg, uint32_t at) const;
 
-        bool match_symbol(std::vector<Token>& tokens);
-        bool match_builtin_func(std::vector<Token>& tokens);
-        bool match_keyword(std::vector<Token>& tokens);
-        bool match_identifier(std::vector<Token>& tokens);
-        bool match_string_literal(std::vector<Token>& tokens);
-        bool match_number(std::vector<Token>& tokens);
+        bool match_symbol(TokenBuffer& tokens);
+        bool match_word(TokenBuffer& tokens);
+        bool match_string_literal(TokenBuffer& tokens);
+        bool match_number(TokenBuffer& tokens);
 
-        void lex_line(std::vector<Token>& tokens);
+        void lex_line(TokenBuffer& tokens);
+        size_t lex_next_line(TokenBuffer& tokens, size_t start);
+        void lex_lines(TokenBuffer& tokens, size_t start, size_t stop);
+        TokenBuffer lex_chunks(size_t count) const;
 
     public:
         explicit Lexer(const std::string& file_name);
 
-        std::vector<Token> lex_file();
+        // The whole source file, mapped on first use. lex_file lexes this
+        // same buffer, so anything derived from it matches the tokens.
+        std::string_view source_text();
+
+        // Tokens returned by the lexer slice into its source buffer,
+        // so the lexer must outlive them. Large files are split at line
+        // boundaries and lexed on one thread per core.
+        TokenBuffer lex_file();
+
+        // Re-lexes only the edited lines of 'source' and splices them into the
+        // tokens of the previous version. Untouched lines are copied over with
+        // their offsets shifted. Edits are in previous-source line numbers,
+        // sorted and non-overlapping; 'source' must outlive the result.
+        static TokenBuffer relex(
+            const TokenBuffer& previous,
+            std::string_view source,
+            const std::vector<LineEdit>& edits
+        );
     };
 
 }
@@ -0,0 +1,24 @@
+#ifndef LINE_TABLE_HPP
+#define LINE_TABLE_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace lexer {
+
+    // Start offset of every line in a source buffer. Tokens only store byte
+    // offsets, this turns them back into line/column for diagnostics.
+    class LineTable {
+        std::vector<uint32_t> line_starts;
+
+    public:
+        explicit LineTable(std::string_view source);
+
+        [[nodiscard]] int line_of(uint32_t offset) const;
+        [[nodiscard]] int column_of(uint32_t offset) const;
+    };
+
+}
+
+#endif //LINE_TABLE_HPP
@@ -0,0 +1,89 @@
+#ifndef RESERVED_WORDS_HPP
+#define RESERVED_WORDS_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "token.hpp"
+
+namespace lexer {
+
+    enum DefinedFunction : uint8_t {
+        PRINT,
+        PRINTLN
+    };
+
+    // Every keyword and builtin spelling. Keywords map to their token type,
+    // builtins (spelled 'name!' in source) to their DefinedFunction.
+    struct ReservedWord {
+        std::string_view spelling;
+        bool is_builtin;
+        uint8_t value;
+    };
+
+    inline constexpr std::array<ReservedWord, 4> reserved_words = {{
+        { "dec", false, KW_DEC },
+        { "decm", false, KW_DECM },
+        { "print", true, PRINT },
+        { "println", true, PRINTLN },
+    }};
+
+    inline constexpr size_t reserved_table_size = 8;
+
+    constexpr uint32_t reserved_hash(const std::string_view word, const uint32_t seed) {
+        uint32_t h = 2166136261u ^ seed;
+
+        for (const char c : word) {
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+
+        return h % reserved_table_size;
+    }
+
+    // Smallest seed under which no two reserved words share a slot
+    inline constexpr uint32_t reserved_seed = [] {
+        for (uint32_t seed = 0;; seed++) {
+            std::array<bool, reserved_table_size> used{};
+            bool collision = false;
+
+            for (const auto& word : reserved_words) {
+                const uint32_t slot = reserved_hash(word.spelling, seed);
+                collision = collision || used[slot];
+                used[slot] = true;
+            }
+
+            if (!collision) {
+                return seed;
+            }
+        }
+    }();
+
+    // Slot -> index into reserved_words, -1 for empty slots
+    inline constexpr std::array<int8_t, reserved_table_size> reserved_slots = [] {
+        std::array<int8_t, reserved_table_size> slots{};
+        slots.fill(-1);
+
+        for (size_t i = 0; i < reserved_words.size(); i++) {
+            slots[reserved_hash(reserved_words[i].spelling, reserved_seed)] = static_cast<int8_t>(i);
+        }
+
+        return slots;
+    }();
+
+    // One hash and one compare; nullptr for ordinary identifiers
+    constexpr const ReservedWord* find_reserved_word(const std::string_view word) {
+        const int8_t index = reserved_slots[reserved_hash(word, reserved_seed)];
+
+        if (index < 0 || reserved_words[index].spelling != word) {
+            return nullptr;
+        }
+
+        return &reserved_words[index];
+    }
+
+    std::string_view defined_function_name(DefinedFunction func);
+
+}
+
+#endif //RESERVED_WORDS_HPP
@@ -0,0 +1,24 @@
+#ifndef SCAN_KERNELS_HPP
+#define SCAN_KERNELS_HPP
+
+#include <string_view>
+
+namespace lexer {
+
+    // Hot loops of the lexer. Each kernel scans src starting at 'from' and
+    // returns the index of the first byte that ends the run, or src.length().
+    // On x86 they process 16 (SSE2) or 32 (AVX2) bytes per step, picked once at
+    // runtime; other targets use the scalar versions.
+
+    // Skips ' ', '\t', '\n', '\v', '\f' and '\r'.
+    size_t skip_whitespace(std::string_view src, size_t from);
+
+    // Skips identifier characters: [a-zA-Z0-9_].
+    size_t skip_word_chars(std::string_view src, size_t from);
+
+    // Finds the next '"'.
+    size_t find_quote(std::string_view src, size_t from);
+
+}
+
+#endif //SCAN_KERNELS_HPP
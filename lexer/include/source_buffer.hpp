@@ -0,0 +1,33 @@
+#ifndef SOURCE_BUFFER_HPP
+#define SOURCE_BUFFER_HPP
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace lexer {
+
+    // Read-only view of a whole source file. The file is memory mapped where
+    // the platform supports it, otherwise it is read in until end of file.
+    class SourceBuffer {
+        const char* data;
+        size_t size;
+        bool mapped;
+        std::string fallback;
+
+        // Takes ownership of file and closes it
+        void read_whole_file(std::FILE* file);
+
+    public:
+        explicit SourceBuffer(const std::string& file_name);
+        ~SourceBuffer();
+
+        SourceBuffer(const SourceBuffer&) = delete;
+        SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+        [[nodiscard]] std::string_view view() const;
+    };
+
+}
+
+#endif //SOURCE_BUFFER_HPP
@@ -1,11 +1,16 @@
 #ifndef TOKEN_HPP
 #define TOKEN_HPP
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "interner.hpp"
 
 namespace lexer {
 
-    enum TokenType {
+    enum TokenType : uint8_t {
         BUILTIN_FUNC,
         LINE_END,
         STRING_LITERAL,
@@ -19,18 +24,47 @@ namespace lexer {
         RIGHT_PAREN,
         EQUALS,
         IDENTIFIER,
-        KEYWORD
+        KW_DEC,
+        KW_DECM
     };
 
-    struct Token {
-        TokenType type;
-        std::string value;
+    std::string token_type_str(TokenType type);
+
+    // Token stream stored as parallel arrays. Each token is a kind, the byte
+    // offset where it starts in the source and a 32-bit payload:
+    //   IDENTIFIER                     - interned SymbolId
+    //   BUILTIN_FUNC                   - DefinedFunction
+    //   STRING_LITERAL                 - length of the body, offset is past the quote
+    //   FLOAT, INTEGER                 - length of the spelling
+    //   keywords, symbols, LINE_END    - unused
+    class TokenBuffer {
+        std::string_view source;
+        std::vector<TokenType> types;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> payloads;
+
+    public:
+        TokenBuffer() = default;
+        explicit TokenBuffer(std::string_view source);
+
+        void push(TokenType type, uint32_t offset, uint32_t payload = 0);
+        void append(const TokenBuffer& other);
+
+        // Appends tokens [first, last) of other, moving their offsets by shift
+        void append(const TokenBuffer& other, size_t first, size_t last, int64_t shift);
+
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] TokenType type(size_t i) const;
+        [[nodiscard]] uint32_t offset(size_t i) const;
+        [[nodiscard]] uint32_t payload(size_t i) const;
 
-        Token(TokenType type, const std::string& value);
+        // Index of the next token of the given type at or after from, or size()
+        [[nodiscard]] size_t find(TokenType type, size_t from) const;
 
-        explicit Token(TokenType type);
+        [[nodiscard]] SymbolId symbol(size_t i) const;
+        [[nodiscard]] std::string_view text(size_t i) const;
 
-        [[nodiscard]] std::string to_str() const;
+        [[nodiscard]] std::string to_str(size_t i) const;
     };
 
 }
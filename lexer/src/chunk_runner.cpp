@@ -0,0 +1,63 @@
+#include "../include/chunk_runner.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace lexer {
+
+    size_t chunk_count(const size_t size, const size_t min_chunk_size) {
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        return std::clamp<size_t>(size / min_chunk_size, 1, cores);
+    }
+
+    std::vector<size_t> chunk_bounds(
+        const size_t begin,
+        const size_t end,
+        const size_t count,
+        const std::function<size_t(size_t target)>& find_separator
+    ) {
+        std::vector<size_t> bounds{ begin };
+
+        for (size_t i = 1; i < count; i++) {
+            const size_t target = std::max(bounds.back(), begin + (end - begin) * i / count);
+            const size_t separator = find_separator(target);
+
+            if (separator >= end) {
+                break;
+            }
+
+            bounds.push_back(separator + 1);
+        }
+
+        bounds.push_back(end);
+        return bounds;
+    }
+
+    void run_chunks(const std::vector<size_t>& bounds, const std::function<void(size_t chunk)>& run_chunk) {
+        const size_t chunks = bounds.size() - 1;
+        std::vector<std::exception_ptr> errors(chunks);
+        std::vector<std::thread> workers;
+
+        for (size_t i = 0; i < chunks; i++) {
+            workers.emplace_back([&, i] {
+                try {
+                    run_chunk(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (const auto& err : errors) {
+            if (err) {
+                std::rethrow_exception(err);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,46 @@
+#include "../include/interner.hpp"
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace lexer {
+
+    struct SymbolTable {
+        // Deque keeps every spelling at a stable address for the views below
+        std::deque<std::string> names;
+        std::unordered_map<std::string_view, SymbolId> ids;
+        std::mutex mutex;
+    };
+
+    static SymbolTable& symbol_table() {
+        static SymbolTable table;
+        return table;
+    }
+
+    SymbolId intern(const std::string_view name) {
+        SymbolTable& table = symbol_table();
+        std::lock_guard lock(table.mutex);
+
+        if (const auto it = table.ids.find(name); it != table.ids.end()) {
+            return it->second;
+        }
+
+        const auto id = static_cast<SymbolId>(table.names.size());
+        const std::string& stored = table.names.emplace_back(name);
+        table.ids.emplace(stored, id);
+
+        return id;
+    }
+
+    std::string_view symbol_name(const SymbolId id) {
+        SymbolTable& table = symbol_table();
+        std::lock_guard lock(table.mutex);
+        assert(id < table.names.size() && "Symbol id out of range.");
+
+        return table.names[id];
+    }
+
+}
@@ -1,215 +1,351 @@
-#include <fstream>
-#include <iostream>
-#include <regex>
+#include <array>
+#include <stdexcept>
+#include <string_view>
 
 #include "../include/lexer.hpp"
+#include "../include/chunk_runner.hpp"
 #include "../include/lex_error.hpp"
+#include "../include/line_table.hpp"
+#include "../include/reserved_words.hpp"
+#include "../include/scan_kernels.hpp"
 
 namespace lexer {
 
     Lexer::Lexer(const std::string& file_name) {
         this->file_name = file_name;
+        this->buffer = {};
         this->current_source = {};
-        this->line = 0;
-        this->index = 0;
+        this->line_start = 0;
+        this->cursor = 0;
     }
 
     char Lexer::peek() const {
-        if (current_source.empty()) {
+        if (cursor >= current_source.length()) {
             return '\0';
         }
 
-        return current_source[0];
+        return current_source[cursor];
     }
 
-    char Lexer::consume() {
-        if (current_source.empty()) {
-            return '\0';
+    std::string_view Lexer::rest() const {
+        return current_source.substr(cursor);
+    }
+
+    uint32_t Lexer::offset() const {
+        return line_start + static_cast<uint32_t>(cursor);
+    }
+
+    SymbolId Lexer::intern_word(const std::string_view word) {
+        // Local cache so the shared interner (and its lock) is hit once per name
+        if (const auto it = symbol_cache.find(word); it != symbol_cache.end()) {
+            return it->second;
         }
 
-        const char c = current_source[0];
-        current_source = current_source.substr(1);
-        index++;
+        const SymbolId id = intern(word);
+        symbol_cache.emplace(word, id);
 
-        return c;
+        return id;
     }
 
-    bool Lexer::match_symbol(std::vector<Token>& tokens) {
-        const std::vector<std::pair<char, TokenType>> symbol_map = {
-            { '+', ADD },
-            { '-', SUBTRACT },
-            { '*', MULTIPLY },
-            { '/', DIVIDE },
-            { '(', LEFT_PAREN },
-            { ')', RIGHT_PAREN },
-            { '=', EQUALS },
-        };
+    void Lexer::error(const std::string& msg, const uint32_t at) const {
+        const LineTable lines(buffer);
+        throw LexError(msg, lines.line_of(at), lines.column_of(at));
+    }
 
-        for (const auto& [key, value] : symbol_map) {
-            if (current_source[0] == key) {
-                tokens.emplace_back(value);
-                current_source = current_source.substr(1);
-                index++;
+    enum CharClass : unsigned char {
+        CC_OTHER,
+        CC_SPACE,
+        CC_WORD_START,
+        CC_DIGIT,
+        CC_QUOTE,
+        CC_SYMBOL
+    };
 
-                return true;
-            }
+    static constexpr std::array<CharClass, 256> char_classes = [] {
+        std::array<CharClass, 256> table{};
+
+        for (const char c : std::string_view(" \t\n\v\f\r")) {
+            table[static_cast<unsigned char>(c)] = CC_SPACE;
         }
 
-        return false;
-    }
+        for (int c = 'a'; c <= 'z'; c++) table[c] = CC_WORD_START;
+        for (int c = 'A'; c <= 'Z'; c++) table[c] = CC_WORD_START;
+        table['_'] = CC_WORD_START;
 
-    bool Lexer::match_builtin_func(std::vector<Token>& tokens) {
-        std::smatch match{};
-        const std::regex reg(R"([a-zA-Z_][a-zA-Z0-9_]*!)");
+        for (int c = '0'; c <= '9'; c++) table[c] = CC_DIGIT;
 
-        if (
-            std::regex_search(current_source, match, reg) &&
-            match.position() == 0
-        ) {
-            const std::string m_str = match.str(0);
+        table['"'] = CC_QUOTE;
 
-            tokens.emplace_back(
-                BUILTIN_FUNC,
-                m_str.substr(m_str.length())
-            );
+        for (const char c : std::string_view("+-*/()=")) {
+            table[static_cast<unsigned char>(c)] = CC_SYMBOL;
+        }
+
+        return table;
+    }();
+
+    static CharClass char_class(const char c) {
+        return char_classes[static_cast<unsigned char>(c)];
+    }
+
+    static bool is_digit(const char c) {
+        return char_class(c) == CC_DIGIT;
+    }
 
-            index += static_cast<int>(m_str.length());
-            current_source = current_source.substr(m_str.length());
-            return true;
+    bool Lexer::match_symbol(TokenBuffer& tokens) {
+        TokenType type;
+
+        switch (peek()) {
+            case '+': type = ADD; break;
+            case '-': type = SUBTRACT; break;
+            case '*': type = MULTIPLY; break;
+            case '/': type = DIVIDE; break;
+            case '(': type = LEFT_PAREN; break;
+            case ')': type = RIGHT_PAREN; break;
+            case '=': type = EQUALS; break;
+            default: return false;
         }
 
-        return false;
+        tokens.push(type, offset());
+        cursor++;
+
+        return true;
     }
 
-     bool Lexer::match_keyword(std::vector<Token>& tokens) {
-        std::smatch match;
+    bool Lexer::match_word(TokenBuffer& tokens) {
+        if (char_class(peek()) != CC_WORD_START) {
+            return false;
+        }
+
+        const std::string_view src = rest();
 
-        const std::vector<std::regex> keywords = {
-            std::regex("decm"),
-            std::regex("dec"),
-        };
+        size_t len = skip_word_chars(src, 1);
+        const std::string_view word = src.substr(0, len);
 
-        for (const auto& keyword : keywords) {
-            if (
-                std::regex_search(current_source, match, keyword) &&
-                match.position() == 0
-            ) {
-                const std::string& str = match.str(0);
-                tokens.emplace_back(KEYWORD, str);
-                current_source = current_source.substr(str.length());
-                index += static_cast<int>(str.length());
-                return true;
+        const ReservedWord* reserved = find_reserved_word(word);
+
+        // Builtin calls are spelled like Rust macros: 'name!'
+        if (len < src.length() && src[len] == '!') {
+            if (!reserved || !reserved->is_builtin) {
+                error("Unknown builtin function '" + std::string(word) + "!'.", offset());
             }
+
+            tokens.push(BUILTIN_FUNC, offset(), reserved->value);
+            len++;
+        } else if (reserved && !reserved->is_builtin) {
+            tokens.push(static_cast<TokenType>(reserved->value), offset());
+        } else {
+            tokens.push(IDENTIFIER, offset(), intern_word(word));
         }
 
-        return false;
-     }
+        cursor += len;
+        return true;
+    }
 
-    bool Lexer::match_identifier(std::vector<Token>& tokens) {
-        std::smatch match;
-        const std::regex reg(R"([a-zA-Z_][a-zA-Z0-9_]*)");
+    bool Lexer::match_string_literal(TokenBuffer& tokens) {
+        if (peek() != '"') {
+            return false;
+        }
 
-        if (
-            std::regex_search(current_source, match, reg) &&
-            match.position() == 0
-        ) {
-            const std::string& name = match.str(0);
-            tokens.emplace_back(IDENTIFIER, name);
-            current_source = current_source.substr(name.length());
-            index += static_cast<int>(name.length());
-            return true;
+        const size_t start = cursor;
+        const size_t closing = find_quote(current_source, start + 1);
+
+        // Unterminated literals run to the end of the line, which is where
+        // the error is reported, as it always has been
+        if (closing == current_source.length()) {
+            error("Missing closing quote for string literal.", line_start + static_cast<uint32_t>(closing));
         }
 
-        return false;
+        tokens.push(STRING_LITERAL, offset() + 1, static_cast<uint32_t>(closing - start - 1));
+        cursor = closing + 1;
+        return true;
     }
 
-    bool Lexer::match_string_literal(std::vector<Token>& tokens) {
-        if (peek() != '"') {
+    bool Lexer::match_number(TokenBuffer& tokens) {
+        if (!is_digit(peek())) {
             return false;
         }
 
-        // Consume opening quote
-        consume();
+        const std::string_view src = rest();
+
+        size_t len = 1;
+        while (len < src.length() && is_digit(src[len])) {
+            len++;
+        }
+
+        bool is_float = false;
+
+        // A fractional part needs at least one digit after the dot
+        if (
+            len + 1 < src.length() &&
+            src[len] == '.' &&
+            is_digit(src[len + 1])
+        ) {
+            is_float = true;
+            len += 2;
+
+            while (len < src.length() && is_digit(src[len])) {
+                len++;
+            }
+        }
 
-        std::string str{};
-        bool has_closing = false;
+        tokens.push(is_float ? FLOAT : INTEGER, offset(), static_cast<uint32_t>(len));
+        cursor += len;
+        return true;
+    }
 
-        while (peek() != '\0') {
-            if (peek() == '"') {
-                consume();
-                has_closing = true;
-                break;
+    void Lexer::lex_line(TokenBuffer& tokens) {
+        while (cursor < current_source.length()) {
+            bool matched = false;
+
+            switch (char_class(peek())) {
+                case CC_SPACE: cursor = skip_whitespace(current_source, cursor); continue;
+                case CC_WORD_START: matched = match_word(tokens); break;
+                case CC_DIGIT: matched = match_number(tokens); break;
+                case CC_QUOTE: matched = match_string_literal(tokens); break;
+                case CC_SYMBOL: matched = match_symbol(tokens); break;
+                case CC_OTHER: break;
             }
 
-            str += consume();
+            if (!matched) {
+                error("Unable to identify token from source:\n" + std::string(rest()), offset());
+            }
         }
+    }
+
+    size_t Lexer::lex_next_line(TokenBuffer& tokens, const size_t start) {
+        size_t end = buffer.find('\n', start);
 
-        if (!has_closing) {
-            throw LexError("Missing closing quote for string literal.", line, index);
+        if (end == std::string_view::npos) {
+            end = buffer.length();
         }
 
-        tokens.emplace_back(STRING_LITERAL, str);
-        return true;
+        current_source = buffer.substr(start, end - start);
+        line_start = static_cast<uint32_t>(start);
+        cursor = 0;
+
+        lex_line(tokens);
+        tokens.push(LINE_END, static_cast<uint32_t>(end));
+
+        return end + 1;
     }
 
-    bool Lexer::match_number(std::vector<Token>& tokens) {
-        std::smatch match;
-        const std::regex reg(R"([0-9]+(\.[0-9]+)?)");
+    void Lexer::lex_lines(TokenBuffer& tokens, size_t start, const size_t stop) {
+        while (start < stop) {
+            start = lex_next_line(tokens, start);
+        }
+    }
 
-        if (
-            std::regex_search(current_source, match, reg) &&
-            match.position() == 0
-        ) {
-            const std::string m_str = match.str(0);
+    // Below this size the thread start-up costs more than lexing does
+    static constexpr size_t min_chunk_size = 1 << 20;
 
-            if (m_str.find('.') != std::string::npos) {
-                tokens.emplace_back(FLOAT, m_str);
-            } else {
-                tokens.emplace_back(INTEGER, m_str);
-            }
+    TokenBuffer Lexer::lex_chunks(const size_t count) const {
+        // Chunks always start right after a newline, no token spans one
+        const std::vector<size_t> bounds = chunk_bounds(0, buffer.length(), count, [&](const size_t target) {
+            return buffer.find('\n', target);
+        });
+
+        std::vector<TokenBuffer> results(bounds.size() - 1, TokenBuffer(buffer));
 
-            index += static_cast<int>(m_str.length());
-            current_source = current_source.substr(m_str.length());
-            return true;
+        run_chunks(bounds, [&](const size_t i) {
+            Lexer worker(file_name);
+            worker.buffer = buffer;
+            worker.lex_lines(results[i], bounds[i], bounds[i + 1]);
+        });
+
+        TokenBuffer tokens(buffer);
+
+        for (const auto& chunk : results) {
+            tokens.append(chunk);
         }
 
-        return false;
+        return tokens;
     }
 
-    void Lexer::lex_line(std::vector<Token>& tokens) {
-        while (!current_source.empty()) {
-            if (isspace(peek())) {
-                consume();
-                continue;
-            }
+    std::string_view Lexer::source_text() {
+        if (!source) {
+            source = std::make_unique<SourceBuffer>(file_name);
+            buffer = source->view();
+        }
 
-            if (match_symbol(tokens)) continue;
-            if (match_builtin_func(tokens)) continue;
-            if (match_keyword(tokens)) continue;
-            if (match_string_literal(tokens)) continue;
-            if (match_identifier(tokens)) continue;
-            if (match_number(tokens)) continue;
+        return buffer;
+    }
 
-            throw LexError("Unable to identify token from source:\n" + current_source, line, index);
+    TokenBuffer Lexer::lex_file() {
+        source_text();
+
+        if (buffer.length() > UINT32_MAX) {
+            throw std::runtime_error("Source file is too large.");
         }
+
+        if (const size_t count = chunk_count(buffer.length(), min_chunk_size); count > 1) {
+            return lex_chunks(count);
+        }
+
+        TokenBuffer tokens(buffer);
+        lex_lines(tokens, 0, buffer.length());
+
+        return tokens;
+    }
+
+    // Start offset of the line following the token before 'token' (a LINE_END)
+    static size_t line_start_after(const TokenBuffer& tokens, const size_t token) {
+        return token == 0 ? 0 : tokens.offset(token - 1) + 1;
     }
 
-    std::vector<Token> Lexer::lex_file() {
-        std::vector<Token> tokens{};
-        std::ifstream file(file_name);
+    // Index just past the LINE_END that closes the line_count'th line from 'token'
+    static size_t skip_token_lines(const TokenBuffer& tokens, size_t token, const size_t line_count) {
+        for (size_t i = 0; i < line_count; i++) {
+            token = tokens.find(LINE_END, token);
 
-        if (!file.is_open()) {
-            throw std::runtime_error("Failed to open source file.");
+            if (token == tokens.size()) {
+                throw std::out_of_range("Line edit is past the end of the previous token stream.");
+            }
+
+            token++;
         }
 
-        while (std::getline(file, current_source)) {
-            lex_line(tokens);
-            tokens.emplace_back(LINE_END);
-            line++;
-            index = 0;
+        return token;
+    }
+
+    TokenBuffer Lexer::relex(
+        const TokenBuffer& previous,
+        const std::string_view source,
+        const std::vector<LineEdit>& edits
+    ) {
+        if (source.length() > UINT32_MAX) {
+            throw std::runtime_error("Source file is too large.");
+        }
+
+        Lexer lexer("");
+        lexer.buffer = source;
+
+        TokenBuffer tokens(source);
+        size_t token = 0;
+        uint32_t line = 0;
+
+        // How far unchanged text has moved between the previous and new source
+        int64_t shift = 0;
+
+        for (const auto& edit : edits) {
+            if (edit.first_line < line) {
+                throw std::invalid_argument("Line edits must be sorted and must not overlap.");
+            }
+
+            const size_t kept_end = skip_token_lines(previous, token, edit.first_line - line);
+            tokens.append(previous, token, kept_end, shift);
+
+            size_t start = line_start_after(previous, kept_end) + shift;
+            token = skip_token_lines(previous, kept_end, edit.old_line_count);
+
+            for (uint32_t i = 0; i < edit.new_line_count && start <= source.length(); i++) {
+                start = lexer.lex_next_line(tokens, start);
+            }
+
+            shift = static_cast<int64_t>(start) - static_cast<int64_t>(line_start_after(previous, token));
+            line = edit.first_line + edit.old_line_count;
         }
 
-        file.close();
+        tokens.append(previous, token, previous.size(), shift);
         return tokens;
     }
 
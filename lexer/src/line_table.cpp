@@ -0,0 +1,24 @@
+#include "../include/line_table.hpp"
+
+#include <algorithm>
+
+namespace lexer {
+
+    LineTable::LineTable(const std::string_view source) {
+        line_starts.push_back(0);
+
+        for (size_t i = source.find('\n'); i != std::string_view::npos; i = source.find('\n', i + 1)) {
+            line_starts.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+
+    int LineTable::line_of(const uint32_t offset) const {
+        const auto it = std::upper_bound(line_starts.begin(), line_starts.end(), offset);
+        return static_cast<int>(it - line_starts.begin()) - 1;
+    }
+
+    int LineTable::column_of(const uint32_t offset) const {
+        return static_cast<int>(offset - line_starts[line_of(offset)]);
+    }
+
+}
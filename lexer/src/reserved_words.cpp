@@ -0,0 +1,22 @@
+#include "../include/reserved_words.hpp"
+
+#include <cassert>
+
+namespace lexer {
+
+    static_assert(find_reserved_word("decm")->value == KW_DECM);
+    static_assert(find_reserved_word("println")->value == PRINTLN);
+    static_assert(find_reserved_word("decmx") == nullptr);
+
+    std::string_view defined_function_name(const DefinedFunction func) {
+        for (const auto& word : reserved_words) {
+            if (word.is_builtin && word.value == func) {
+                return word.spelling;
+            }
+        }
+
+        assert(false && "Can't find name for DefinedFunction enum.");
+        return "";
+    }
+
+}
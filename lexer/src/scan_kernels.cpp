@@ -0,0 +1,190 @@
+#include "../include/scan_kernels.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CHERRY_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace lexer {
+
+    static bool is_space_byte(const unsigned char c) {
+        return c == ' ' || static_cast<unsigned char>(c - '\t') <= '\r' - '\t';
+    }
+
+    static bool is_word_byte(const unsigned char c) {
+        return static_cast<unsigned char>((c | 0x20) - 'a') <= 'z' - 'a' ||
+            static_cast<unsigned char>(c - '0') <= 9 ||
+            c == '_';
+    }
+
+    static size_t skip_whitespace_scalar(const char* p, size_t i, const size_t n) {
+        while (i < n && is_space_byte(p[i])) i++;
+        return i;
+    }
+
+    static size_t skip_word_chars_scalar(const char* p, size_t i, const size_t n) {
+        while (i < n && is_word_byte(p[i])) i++;
+        return i;
+    }
+
+    static size_t find_quote_scalar(const char* p, size_t i, const size_t n) {
+        while (i < n && p[i] != '"') i++;
+        return i;
+    }
+
+#if defined(CHERRY_SIMD_X86)
+
+    // Unsigned "lo <= x <= lo + span" per byte, built from SSE2 ops only
+    __attribute__((target("sse2")))
+    static __m128i in_range_128(const __m128i x, const char lo, const char span) {
+        const __m128i t = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+        return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(span)), t);
+    }
+
+    __attribute__((target("sse2")))
+    static __m128i space_mask_128(const __m128i x) {
+        return _mm_or_si128(
+            _mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+            in_range_128(x, '\t', '\r' - '\t')
+        );
+    }
+
+    __attribute__((target("sse2")))
+    static __m128i word_mask_128(const __m128i x) {
+        const __m128i letters = in_range_128(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z' - 'a');
+        const __m128i digits = in_range_128(x, '0', 9);
+        const __m128i underscore = _mm_cmpeq_epi8(x, _mm_set1_epi8('_'));
+        return _mm_or_si128(_mm_or_si128(letters, digits), underscore);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t skip_whitespace_sse2(const char* p, size_t i, const size_t n) {
+        for (; i + 16 <= n; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const unsigned mask = ~_mm_movemask_epi8(space_mask_128(x)) & 0xFFFFu;
+
+            if (mask) return i + __builtin_ctz(mask);
+        }
+
+        return skip_whitespace_scalar(p, i, n);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t skip_word_chars_sse2(const char* p, size_t i, const size_t n) {
+        for (; i + 16 <= n; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const unsigned mask = ~_mm_movemask_epi8(word_mask_128(x)) & 0xFFFFu;
+
+            if (mask) return i + __builtin_ctz(mask);
+        }
+
+        return skip_word_chars_scalar(p, i, n);
+    }
+
+    __attribute__((target("sse2")))
+    static size_t find_quote_sse2(const char* p, size_t i, const size_t n) {
+        const __m128i quote = _mm_set1_epi8('"');
+
+        for (; i + 16 <= n; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, quote));
+
+            if (mask) return i + __builtin_ctz(mask);
+        }
+
+        return find_quote_scalar(p, i, n);
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i in_range_256(const __m256i x, const char lo, const char span) {
+        const __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(span)), t);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t skip_whitespace_avx2(const char* p, size_t i, const size_t n) {
+        for (; i + 32 <= n; i += 32) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const __m256i spaces = _mm256_or_si256(
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                in_range_256(x, '\t', '\r' - '\t')
+            );
+            const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(spaces));
+
+            if (mask) return i + __builtin_ctz(mask);
+        }
+
+        return skip_whitespace_sse2(p, i, n);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t skip_word_chars_avx2(const char* p, size_t i, const size_t n) {
+        for (; i + 32 <= n; i += 32) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const __m256i letters = in_range_256(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z' - 'a');
+            const __m256i digits = in_range_256(x, '0', 9);
+            const __m256i underscore = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_'));
+            const __m256i word = _mm256_or_si256(_mm256_or_si256(letters, digits), underscore);
+            const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(word));
+
+            if (mask) return i + __builtin_ctz(mask);
+        }
+
+        return skip_word_chars_sse2(p, i, n);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t find_quote_avx2(const char* p, size_t i, const size_t n) {
+        const __m256i quote = _mm256_set1_epi8('"');
+
+        for (; i + 32 <= n; i += 32) {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, quote));
+
+            if (mask) return i + __builtin_ctz(mask);
+        }
+
+        return find_quote_sse2(p, i, n);
+    }
+
+#endif
+
+    using ScanKernel = size_t (*)(const char*, size_t, size_t);
+
+    struct ScanKernels {
+        ScanKernel skip_whitespace;
+        ScanKernel skip_word_chars;
+        ScanKernel find_quote;
+    };
+
+    static ScanKernels select_kernels() {
+    #if defined(CHERRY_SIMD_X86)
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2")) {
+            return { skip_whitespace_avx2, skip_word_chars_avx2, find_quote_avx2 };
+        }
+
+        if (__builtin_cpu_supports("sse2")) {
+            return { skip_whitespace_sse2, skip_word_chars_sse2, find_quote_sse2 };
+        }
+    #endif
+
+        return { skip_whitespace_scalar, skip_word_chars_scalar, find_quote_scalar };
+    }
+
+    static const ScanKernels kernels = select_kernels();
+
+    size_t skip_whitespace(const std::string_view src, const size_t from) {
+        return kernels.skip_whitespace(src.data(), from, src.length());
+    }
+
+    size_t skip_word_chars(const std::string_view src, const size_t from) {
+        return kernels.skip_word_chars(src.data(), from, src.length());
+    }
+
+    size_t find_quote(const std::string_view src, const size_t from) {
+        return kernels.find_quote(src.data(), from, src.length());
+    }
+
+}
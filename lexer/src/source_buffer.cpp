@@ -0,0 +1,100 @@
+#include "../include/source_buffer.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lexer {
+
+    SourceBuffer::SourceBuffer(const std::string& file_name) {
+        this->data = nullptr;
+        this->size = 0;
+        this->mapped = false;
+
+    #if defined(_WIN32)
+        std::FILE* file = std::fopen(file_name.c_str(), "rb");
+
+        if (!file) {
+            throw std::runtime_error("Failed to open source file.");
+        }
+
+        read_whole_file(file);
+    #else
+        const int fd = open(file_name.c_str(), O_RDONLY);
+
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open source file.");
+        }
+
+        struct stat st{};
+
+        // Empty files and special files can't be mapped, those are read
+        // through the descriptor that is already open. Opening a FIFO a
+        // second time would block forever.
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (addr != MAP_FAILED) {
+                madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+                this->data = static_cast<const char*>(addr);
+                this->size = static_cast<size_t>(st.st_size);
+                this->mapped = true;
+            }
+        }
+
+        if (mapped) {
+            close(fd);
+            return;
+        }
+
+        std::FILE* file = fdopen(fd, "rb");
+
+        if (!file) {
+            close(fd);
+            throw std::runtime_error("Failed to open source file.");
+        }
+
+        read_whole_file(file);
+    #endif
+    }
+
+    SourceBuffer::~SourceBuffer() {
+    #if !defined(_WIN32)
+        if (mapped) {
+            munmap(const_cast<char*>(data), size);
+        }
+    #endif
+    }
+
+    // Reads until EOF without seeking, so pipes and FIFOs work too
+    void SourceBuffer::read_whole_file(std::FILE* file) {
+        char chunk[1 << 16];
+        size_t count;
+
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            fallback.append(chunk, count);
+        }
+
+        const bool failed = std::ferror(file);
+        std::fclose(file);
+
+        if (failed) {
+            throw std::runtime_error("Failed to read source file.");
+        }
+
+        this->data = fallback.data();
+        this->size = fallback.size();
+    }
+
+    std::string_view SourceBuffer::view() const {
+        return { data, size };
+    }
+
+}
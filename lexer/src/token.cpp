@@ -1,43 +1,113 @@
+#include <algorithm>
 #include <cassert>
 
 #include "../include/token.hpp"
+#include "../include/reserved_words.hpp"
 
 namespace lexer {
 
-    Token::Token(const TokenType type, const std::string &value) {
-        this->type = type;
-        this->value = value;
+    std::string token_type_str(const TokenType type) {
+        switch (type) {
+            case BUILTIN_FUNC: return "BUILTIN_FUNC";
+            case STRING_LITERAL: return "STRING_LITERAL";
+            case FLOAT: return "FLOAT";
+            case INTEGER: return "INTEGER";
+            case LINE_END: return "LINE_END";
+            case ADD: return "ADD";
+            case SUBTRACT: return "SUBTRACT";
+            case MULTIPLY: return "MULTIPLY";
+            case DIVIDE: return "DIVIDE";
+            case LEFT_PAREN: return "LEFT_PAREN";
+            case RIGHT_PAREN: return "RIGHT_PAREN";
+            case EQUALS: return "EQUALS";
+            case IDENTIFIER: return "IDENTIFIER";
+            case KW_DEC: return "KW_DEC";
+            case KW_DECM: return "KW_DECM";
+        }
+
+        assert(false && "Can't find str match for token enum.");
+        return "";
+    }
+
+    TokenBuffer::TokenBuffer(const std::string_view source) {
+        this->source = source;
     }
 
-    Token::Token(const TokenType type) {
-        this->type = type;
-        this->value = {};
+    void TokenBuffer::push(const TokenType type, const uint32_t offset, const uint32_t payload) {
+        types.push_back(type);
+        offsets.push_back(offset);
+        payloads.push_back(payload);
     }
 
-    std::string Token::to_str() const {
-        std::string str{};
+    void TokenBuffer::append(const TokenBuffer& other) {
+        append(other, 0, other.size(), 0);
+    }
 
-        switch (type) {
-            case BUILTIN_FUNC: str = "BUILTIN_FUNC"; break;
-            case STRING_LITERAL: str = "STRING_LITERAL"; break;
-            case FLOAT: str = "FLOAT"; break;
-            case INTEGER: str = "INTEGER"; break;
-            case LINE_END: str = "LINE_END"; break;
-            case ADD: str = "ADD"; break;
-            case SUBTRACT: str = "SUBTRACT"; break;
-            case MULTIPLY: str = "MULTIPLY"; break;
-            case DIVIDE: str = "DIVIDE"; break;
-            case LEFT_PAREN: str = "LEFT_PAREN"; break;
-            case RIGHT_PAREN: str = "RIGHT_PAREN"; break;
-            case EQUALS: str = "EQUALS"; break;
-            case IDENTIFIER: str = "IDENTIFIER"; break;
-            case KEYWORD: str = "KEYWORD"; break;
-            default:
-                assert(false && "Can't find str match for token enum.");
+    void TokenBuffer::append(const TokenBuffer& other, const size_t first, const size_t last, const int64_t shift) {
+        types.insert(types.end(), other.types.begin() + first, other.types.begin() + last);
+        payloads.insert(payloads.end(), other.payloads.begin() + first, other.payloads.begin() + last);
+
+        const size_t start = offsets.size();
+        offsets.insert(offsets.end(), other.offsets.begin() + first, other.offsets.begin() + last);
+
+        if (shift != 0) {
+            for (size_t i = start; i < offsets.size(); i++) {
+                offsets[i] = static_cast<uint32_t>(offsets[i] + shift);
+            }
         }
+    }
+
+    size_t TokenBuffer::size() const {
+        return types.size();
+    }
+
+    TokenType TokenBuffer::type(const size_t i) const {
+        return types[i];
+    }
 
-        return std::string(str + "(" + value + ")");
+    uint32_t TokenBuffer::offset(const size_t i) const {
+        return offsets[i];
     }
 
+    uint32_t TokenBuffer::payload(const size_t i) const {
+        return payloads[i];
+    }
+
+    size_t TokenBuffer::find(const TokenType type, const size_t from) const {
+        return std::find(types.begin() + from, types.end(), type) - types.begin();
+    }
+
+    SymbolId TokenBuffer::symbol(const size_t i) const {
+        assert(types[i] == IDENTIFIER && "Token doesn't carry a symbol.");
+        return payloads[i];
+    }
+
+    std::string_view TokenBuffer::text(const size_t i) const {
+        switch (types[i]) {
+            case IDENTIFIER:
+                return symbol_name(payloads[i]);
+
+            case BUILTIN_FUNC:
+                return defined_function_name(static_cast<DefinedFunction>(payloads[i]));
+
+            case STRING_LITERAL:
+            case FLOAT:
+            case INTEGER:
+                return source.substr(offsets[i], payloads[i]);
+
+            case KW_DEC: return "dec";
+            case KW_DECM: return "decm";
+
+            case LINE_END:
+                return {};
+
+            default:
+                return source.substr(offsets[i], 1);
+        }
+    }
+
+    std::string TokenBuffer::to_str(const size_t i) const {
+        return token_type_str(types[i]) + "(" + std::string(text(i)) + ")";
+    }
 
 }
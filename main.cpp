@@ -1,73 +1,195 @@
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 #include "codegen/include/code_gen_error.hpp"
 #include "codegen/include/c_gen.hpp"
 #include "compiler/include/compiler.hpp"
 #include "compiler/include/compiler_error.hpp"
+#include "ir/include/ir_error.hpp"
+#include "ir/include/lowering.hpp"
+#include "ir/include/pass_manager.hpp"
+#include "ir/include/passes.hpp"
+#include "ir/include/statement_cache.hpp"
+#include "ir/include/statement_graph.hpp"
 #include "lexer/include/lexer.hpp"
 #include "lexer/include/lex_error.hpp"
+#include "parser/include/ast_cache.hpp"
 #include "parser/include/parser.hpp"
+#include "parser/include/parse_error.hpp"
+#include "sema/include/sema.hpp"
+#include "sema/include/sema_error.hpp"
+
+// Leaves an identical file untouched, so the binary built from it stays
+// newer and the compiler can skip rebuilding it
+static bool write_if_changed(const std::string& path, const std::string& contents) {
+    {
+        std::ifstream existing(path, std::ios::binary);
+
+        if (existing.is_open() && std::string(std::istreambuf_iterator(existing), {}) == contents) {
+            return true;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << contents;
+    return static_cast<bool>(file);
+}
+
+static int usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " [--hash-cons] [--time-passes] [--cache-stats] [launch_file].ch" << std::endl;
+    return 1;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Error: Expected exactly one argument." << std::endl;
-        std::cerr << "Usage: " << argv[0] << " [launch_file].ch" << std::endl;
-        return 1;
+    // --hash-cons shares identical expression subtrees while parsing
+    bool hash_consing = false;
+    // --time-passes reports how long each IR pass took on stderr
+    bool time_passes = false;
+    // --cache-stats reports how many statements reused a cached value on stderr
+    bool cache_stats = false;
+
+    if (argc < 2) {
+        std::cerr << "Error: Expected a launch file." << std::endl;
+        return usage(argv[0]);
     }
 
-    const std::string launch_path = argv[1];
+    for (int i = 1; i < argc - 1; i++) {
+        const std::string option = argv[i];
+
+        if (option == "--hash-cons") {
+            hash_consing = true;
+        } else if (option == "--time-passes") {
+            time_passes = true;
+        } else if (option == "--cache-stats") {
+            cache_stats = true;
+        } else {
+            std::cerr << "Error: Unknown option '" << option << "'." << std::endl;
+            return usage(argv[0]);
+        }
+    }
+
+    const std::string launch_path = argv[argc - 1];
 
     if (!launch_path.ends_with(".ch")) {
         std::cerr << "Error: Expected launch file with .ch extension." << std::endl;
         return 1;
     }
 
+    const parser::AstCache ast_cache("output/cache/", hash_consing);
+    // Looks up the very buffer that gets lexed on a miss
     lexer::Lexer lexer(launch_path);
-    std::vector<lexer::Token> tokens{};
+    const std::string_view source = lexer.source_text();
+
+    parser::Program program;
+
+    if (auto cached = ast_cache.load(source)) {
+        program = std::move(*cached);
+    } else {
+        lexer::TokenBuffer tokens{};
+
+        try {
+            tokens = lexer.lex_file();
+        } catch (const lexer::LexError& err) {
+            std::cerr << err.what() << std::endl;
+            return 1;
+        }
+
+        parser::Parser parser(tokens, hash_consing);
+
+        try {
+            program = parser.build_program();
+        } catch (const parser::ParseError& err) {
+            std::cerr << err.what() << std::endl;
+            return 1;
+        }
+
+        ast_cache.store(source, program);
+    }
+
+    sema::Annotations annotations;
 
     try {
-        tokens = lexer.lex_file();
-    } catch (const lexer::LexError& err) {
+        sema::Sema sema(program);
+        annotations = sema.analyze();
+    } catch (const sema::SemaError& err) {
         std::cerr << err.what() << std::endl;
         return 1;
     }
 
-    for (const auto& token : tokens) {
-        std::cout << token.to_str() << std::endl;
-    }
+    ir::Function function;
+    // Statements whose fingerprint is unchanged since the last run reuse
+    // their folded value instead of lowering their expression again
+    const ir::StatementGraph graph(program, annotations);
+    ir::StatementCache statement_cache("output/cache/", launch_path);
 
-    return 0;
-    std::cout << "~~~~~~" << std::endl;
+    try {
+        std::vector<const ir::Fragment*> reused(graph.size());
+        size_t reused_count = 0;
 
-    parser::Parser parser(tokens);
-    auto asts = parser.build_program();
+        for (uint32_t stmt = 0; stmt < graph.size(); stmt++) {
+            reused[stmt] = statement_cache.find(graph.fingerprint(stmt));
+            reused_count += reused[stmt] != nullptr;
+        }
 
-    for (const auto& ast : asts) {
-        ast->print(std::cout, 0);
+        if (cache_stats) {
+            std::cerr << "Reused " << reused_count << " of " << graph.size() << " statements." << std::endl;
+        }
+
+        ir::Lowering lowering(program, annotations);
+        function = lowering.lower(reused);
+
+        ir::PassManager passes;
+        passes.add("copy-propagation", ir::propagate_copies);
+        passes.add("constant-folding", ir::fold_constants);
+        // Before anything renumbers the function
+        passes.add("record-fragments", [&](const ir::Function& folded) {
+            statement_cache.record(graph, lowering.values(), folded);
+        });
+        passes.add("precompute-output", ir::precompute_output);
+        passes.add("dead-code-elimination", ir::eliminate_dead_code);
+
+        const auto timings = passes.run(function);
+
+        if (time_passes) {
+            for (const auto& [name, elapsed] : timings) {
+                const std::chrono::duration<double, std::milli> ms = elapsed;
+                std::cerr << "Pass " << name << ": " << ms.count() << " ms" << std::endl;
+            }
+        }
+    } catch (const ir::IRError& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
     }
 
-    std::cout << "~~~~~~" << std::endl;
+    statement_cache.store();
+    program.clear();
 
     try {
-        codegen::CGen gen;
+        codegen::CGen gen(function);
+        std::ostringstream c_source;
+        gen.generate(c_source);
+
         std::filesystem::create_directories("output/");
-        std::ofstream file("output/test.c");
 
-        if (!file.is_open()) {
+        if (!write_if_changed("output/test.c", c_source.str())) {
             std::cerr << "Failed to open output file." << std::endl;
             return 1;
         }
-
-        gen.generate(asts, file);
     } catch (const codegen::CodeGenError& err) {
         std::cerr << err.what() << std::endl;
         return 1;
     }
 
     std::cout << "File transpiled to c." << std::endl;
-    asts.clear();
 
     compiler::Compiler compiler("output/test.c");
 
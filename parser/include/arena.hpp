@@ -0,0 +1,44 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace parser {
+
+    // Bump allocator owning every string payload of a compilation. Nothing
+    // allocated here is freed individually, the whole program is released
+    // at once by reset() or the destructor.
+    class Arena {
+        std::vector<std::unique_ptr<std::byte[]>> blocks;
+        std::byte* cursor;
+        size_t remaining;
+
+        void grow(size_t min_size);
+
+    public:
+        Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // The moved-from arena is left empty, never pointing into blocks it
+        // no longer owns
+        Arena(Arena&& other) noexcept;
+        Arena& operator=(Arena&& other) noexcept;
+
+        void* allocate(size_t size, size_t align);
+
+        std::string_view copy_string(std::string_view str);
+
+        // Takes ownership of everything other allocated, other is left empty
+        void adopt(Arena&& other);
+
+        void reset();
+    };
+
+}
+
+#endif //ARENA_HPP
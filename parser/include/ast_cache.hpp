@@ -0,0 +1,42 @@
+#ifndef AST_CACHE_HPP
+#define AST_CACHE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "ast_nodes.hpp"
+
+namespace parser {
+
+    // Binary copies of parsed Programs on disk, one file per source hash.
+    // A file holds the raw node, statement and string tables plus the
+    // spellings of every SymbolId, so a hit skips lexing and parsing. It
+    // also records the source's length and checksum, so a source whose hash
+    // collides with another's still misses.
+    //
+    // Hash consing changes the shape of the parsed program, so each mode
+    // keeps its own entries.
+    class AstCache {
+        std::string directory;
+        bool hash_consing;
+
+    public:
+        AstCache(const std::string& directory, bool hash_consing);
+
+        [[nodiscard]] std::string path_for(uint64_t source_hash) const;
+
+        // nullopt when there is no usable entry for source: missing, written
+        // by another version, corrupted, stored for a different source, or
+        // its symbol ids can't be reproduced by the interner
+        [[nodiscard]] std::optional<Program> load(std::string_view source) const;
+
+        // Must run before anything mutates the program. Failing to write is
+        // not an error, the next run just misses.
+        void store(std::string_view source, const Program& program) const;
+    };
+
+}
+
+#endif //AST_CACHE_HPP
@@ -1,15 +1,21 @@
 #ifndef AST_NODES_HPP
 #define AST_NODES_HPP
 
-#include <memory>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <ostream>
+#include <unordered_map>
+#include <vector>
 
+#include "arena.hpp"
 #include "operators.hpp"
+#include "../../lexer/include/interner.hpp"
+#include "../../lexer/include/reserved_words.hpp"
 
 namespace parser {
 
-    enum ASTValueType {
+    enum ASTValueType : uint8_t {
         STRING_LITERAL,
         FLOAT,
         INTEGER,
@@ -21,84 +27,101 @@ namespace parser {
         BINARY_OP,
     };
 
+    // Index of a node in its Program
+    using NodeId = uint32_t;
+
+    // Every node is the same 12 bytes, what a and b hold depends on type:
+    //   STRING_LITERAL                       - a: index into the string table
+    //   INTEGER, FLOAT                       - a: the value's bits
+    //   IDENTIFIER                           - a: SymbolId
+    //   BUILTIN_FUNC                         - op: DefinedFunction, a: argument
+    //   IMM_DECLARE, MUT_DECLARE, ASSIGN_VAR - a: identifier, b: value
+    //   BINARY_OP                            - op: BinaryOperator, a: left, b: right
     struct ASTNode {
         ASTValueType type;
-        virtual ~ASTNode() = default;
-        virtual void print(std::ostream& os, int indent) const = 0;
-    };
-
-    std::string ast_val_type_str(ASTValueType val);
+        uint8_t op;
+        uint32_t a;
+        uint32_t b;
 
-    ASTValueType get_var_type_from_node(ASTNode* node);
+        bool operator==(const ASTNode&) const = default;
+    };
 
-    struct BuiltInFunc final : ASTNode {
-        std::string func_name;
-        std::unique_ptr<ASTNode> arg;
+    struct ASTNodeHash {
+        size_t operator()(const ASTNode& node) const noexcept {
+            uint64_t h = (static_cast<uint64_t>(node.a) << 32 | node.b) * 0x9E3779B97F4A7C15ull;
+            h ^= static_cast<uint64_t>(node.type) << 8 | node.op;
 
-        BuiltInFunc(const std::string& func_name, std::unique_ptr<ASTNode> arg);
-        void print(std::ostream& os, int indent_level) const override;
+            return static_cast<size_t>(h ^ h >> 29);
+        }
     };
 
-    struct StringLiteral final : ASTNode {
-        std::string content;
+    std::string ast_val_type_str(ASTValueType val);
 
-        explicit StringLiteral(const std::string& content);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+    // A whole parsed program: one contiguous node array plus the string
+    // literal table. Children are always added before their parents.
+    //
+    // With hash consing on, literals, identifiers and binary operations are
+    // shared: adding one that already exists returns the existing node, so
+    // expressions form a DAG. Statements are never shared.
+    class Program {
+        std::vector<ASTNode> nodes;
+        std::vector<std::string_view> strings;
+        std::vector<NodeId> statements;
+        Arena arena;
 
-    struct Integer final : ASTNode {
-        int value;
+        bool hash_consing = false;
+        std::unordered_map<ASTNode, NodeId, ASTNodeHash> shared_nodes;
+        std::unordered_map<std::string_view, uint32_t> shared_strings;
 
-        explicit Integer(int value);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+        NodeId push(ASTValueType type, uint8_t op, uint32_t a, uint32_t b);
+        NodeId push_shared(ASTValueType type, uint8_t op, uint32_t a, uint32_t b);
 
-    struct Float final : ASTNode {
-        float value;
+        friend class AstCache;
 
-        explicit Float(float value);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+    public:
+        // Only affects nodes added afterwards
+        void enable_hash_consing();
 
-    struct Identifier final : ASTNode {
-        std::string name;
+        NodeId add_string_literal(std::string_view content);
+        NodeId add_integer(int value);
+        NodeId add_float(float value);
+        NodeId add_identifier(lexer::SymbolId symbol);
+        NodeId add_builtin_func(lexer::DefinedFunction func, NodeId arg);
+        NodeId add_imm_declare(NodeId identifier, NodeId value);
+        NodeId add_mut_declare(NodeId identifier, NodeId value);
+        NodeId add_assign_var(NodeId identifier, NodeId value);
+        NodeId add_binary_op(NodeId left, NodeId right, BinaryOperator op);
 
-        explicit Identifier(const std::string& name);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+        void add_statement(NodeId stmt);
 
-    struct ImmDeclare final : ASTNode {
-        std::unique_ptr<ASTNode> identifier;
-        std::unique_ptr<ASTNode> value;
+        // Moves other's nodes, strings and statements after ours, rebasing
+        // every NodeId and string index it holds
+        void append(Program&& other);
 
-        ImmDeclare(std::unique_ptr<ASTNode> identifier, std::unique_ptr<ASTNode> value);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+        [[nodiscard]] const std::vector<NodeId>& get_statements() const;
+        [[nodiscard]] size_t size() const;
 
-    struct MutDeclare final : ASTNode {
-        std::unique_ptr<ASTNode> identifier;
-        std::unique_ptr<ASTNode> value;
+        [[nodiscard]] ASTValueType type(NodeId id) const;
 
-        MutDeclare(std::unique_ptr<ASTNode> identifier, std::unique_ptr<ASTNode> value);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+        [[nodiscard]] std::string_view string_value(NodeId id) const;
+        [[nodiscard]] int integer_value(NodeId id) const;
+        [[nodiscard]] float float_value(NodeId id) const;
+        [[nodiscard]] lexer::SymbolId symbol(NodeId id) const;
 
-    struct AssignVar final : ASTNode {
-        std::unique_ptr<ASTNode> identifier;
-        std::unique_ptr<ASTNode> value;
+        [[nodiscard]] lexer::DefinedFunction func(NodeId id) const;
+        [[nodiscard]] NodeId arg(NodeId id) const;
 
-        AssignVar(std::unique_ptr<ASTNode> identifier, std::unique_ptr<ASTNode> value);
-        void print(std::ostream& os, int indent_level) const override;
-    };
+        [[nodiscard]] NodeId identifier(NodeId id) const;
+        [[nodiscard]] NodeId value(NodeId id) const;
 
-    struct BinaryOp final : ASTNode {
-        std::unique_ptr<ASTNode> left;
-        std::unique_ptr<ASTNode> right;
-        BinaryOperator op;
+        [[nodiscard]] BinaryOperator op(NodeId id) const;
+        [[nodiscard]] NodeId left(NodeId id) const;
+        [[nodiscard]] NodeId right(NodeId id) const;
 
-        BinaryOp(std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right, BinaryOperator op);
+        void print(std::ostream& os, NodeId id, int indent_level) const;
 
-        void print(std::ostream& os, int indent_level) const override;
+        // Releases every node and string in one go
+        void clear();
     };
 
 }
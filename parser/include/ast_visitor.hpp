@@ -0,0 +1,100 @@
+#ifndef AST_VISITOR_HPP
+#define AST_VISITOR_HPP
+
+#include <utility>
+
+#include "ast_nodes.hpp"
+
+namespace parser {
+
+    // Typed views of a Program node, handed to visitors by visit()
+
+    struct StringLiteral {
+        NodeId id;
+        std::string_view content;
+    };
+
+    struct Integer {
+        NodeId id;
+        int value;
+    };
+
+    struct Float {
+        NodeId id;
+        float value;
+    };
+
+    struct Identifier {
+        NodeId id;
+        lexer::SymbolId symbol;
+    };
+
+    struct BuiltInFunc {
+        NodeId id;
+        lexer::DefinedFunction func;
+        NodeId arg;
+    };
+
+    struct ImmDeclare {
+        NodeId id;
+        NodeId identifier;
+        NodeId value;
+    };
+
+    struct MutDeclare {
+        NodeId id;
+        NodeId identifier;
+        NodeId value;
+    };
+
+    struct AssignVar {
+        NodeId id;
+        NodeId identifier;
+        NodeId value;
+    };
+
+    struct BinaryOp {
+        NodeId id;
+        BinaryOperator op;
+        NodeId left;
+        NodeId right;
+    };
+
+    // Builds a visitor out of several lambdas, one per node view
+    template <typename... Handlers>
+    struct overloaded : Handlers... {
+        using Handlers::operator()...;
+    };
+
+    // Calls visitor with the typed view of node 'id'. A single switch on the
+    // node's type tag; every view is instantiated, so a visitor that misses
+    // a node type (and has no generic 'const auto&' fallback) won't compile.
+    template <typename Visitor>
+    decltype(auto) visit(const Program& program, const NodeId id, Visitor&& visitor) {
+        switch (program.type(id)) {
+            case STRING_LITERAL:
+                return visitor(StringLiteral{ id, program.string_value(id) });
+            case FLOAT:
+                return visitor(Float{ id, program.float_value(id) });
+            case INTEGER:
+                return visitor(Integer{ id, program.integer_value(id) });
+            case IDENTIFIER:
+                return visitor(Identifier{ id, program.symbol(id) });
+            case BUILTIN_FUNC:
+                return visitor(BuiltInFunc{ id, program.func(id), program.arg(id) });
+            case IMM_DECLARE:
+                return visitor(ImmDeclare{ id, program.identifier(id), program.value(id) });
+            case MUT_DECLARE:
+                return visitor(MutDeclare{ id, program.identifier(id), program.value(id) });
+            case ASSIGN_VAR:
+                return visitor(AssignVar{ id, program.identifier(id), program.value(id) });
+            case BINARY_OP:
+                return visitor(BinaryOp{ id, program.op(id), program.left(id), program.right(id) });
+        }
+
+        std::unreachable();
+    }
+
+}
+
+#endif //AST_VISITOR_HPP
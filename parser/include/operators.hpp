@@ -1,6 +1,8 @@
 #ifndef OPERATORS_HPP
 #define OPERATORS_HPP
 
+#include <array>
+#include <cstdint>
 #include <string>
 
 #include "../../lexer/include/token.hpp"
@@ -14,6 +16,28 @@ namespace parser {
         DIVIDE
     };
 
+    // Binding power of a binary operator token, higher binds tighter.
+    // Precedence 0 means the token is not a binary operator.
+    struct OperatorInfo {
+        BinaryOperator op;
+        uint8_t precedence;
+    };
+
+    inline constexpr std::array<OperatorInfo, 256> binary_operators = [] {
+        std::array<OperatorInfo, 256> table{};
+
+        table[lexer::ADD] = { ADD, 1 };
+        table[lexer::SUBTRACT] = { SUBTRACT, 1 };
+        table[lexer::MULTIPLY] = { MULTIPLY, 2 };
+        table[lexer::DIVIDE] = { DIVIDE, 2 };
+
+        return table;
+    }();
+
+    constexpr const OperatorInfo& binary_operator_info(const lexer::TokenType type) {
+        return binary_operators[type];
+    }
+
     bool is_binary_op(lexer::TokenType type);
 
     std::string binary_operator_to_str(BinaryOperator op);
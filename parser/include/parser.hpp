@@ -9,33 +9,48 @@
 namespace parser {
 
     class Parser {
-        const std::vector<lexer::Token>& tokens;
+        const lexer::TokenBuffer& tokens;
         size_t index;
 
-        [[nodiscard]] const lexer::Token& peek() const;
-        [[nodiscard]] const lexer::Token& backPeek() const;
+        // One past the last token this parser may consume
+        size_t end;
+
+        bool hash_consing;
+        Program program;
+
+        // Expression stacks, kept between expressions to reuse their storage.
+        // An open parenthesis sits on the operator stack with precedence 0.
+        std::vector<NodeId> operand_stack;
+        std::vector<OperatorInfo> operator_stack;
+
+        [[nodiscard]] lexer::TokenType peek() const;
+        [[nodiscard]] size_t backPeek() const;
         [[nodiscard]] bool is_at_end() const;
-        [[nodiscard]] const lexer::Token& consume();
+        [[nodiscard]] size_t consume();
         void advance();
         [[nodiscard]] bool check(lexer::TokenType type) const;
-        [[nodiscard]] const lexer::Token& expect(lexer::TokenType type, const std::string& err_msg);
+        [[nodiscard]] size_t expect(lexer::TokenType type, const std::string& err_msg);
         void expect_symbol(lexer::TokenType type, const std::string& err_msg);
 
-        std::unique_ptr<ASTNode> build_factor();
-        std::unique_ptr<ASTNode> build_term();
-        std::unique_ptr<ASTNode> build_expr();
+        NodeId build_operand();
+        void reduce_operator();
+        NodeId build_expr();
+
+        NodeId build_imm_declare();
+        NodeId build_mut_declare();
+        NodeId build_assign_var();
+        NodeId build_builtin_func_call();
 
-        std::unique_ptr<ASTNode> build_imm_declare();
-        std::unique_ptr<ASTNode> build_mut_declare();
-        std::unique_ptr<ASTNode> build_assign_var();
-        std::unique_ptr<ASTNode> build_builtin_func_call();
+        NodeId build_statement();
 
-        std::unique_ptr<ASTNode> build_statement();
+        void build_statements();
+        [[nodiscard]] Program build_chunks(size_t count) const;
 
     public:
-        explicit Parser(const std::vector<lexer::Token>& tokens);
+        // hash_consing shares identical expression subtrees, see Program
+        explicit Parser(const lexer::TokenBuffer& tokens, bool hash_consing = false);
 
-        std::vector<std::unique_ptr<ASTNode>> build_program();
+        Program build_program();
     };
 
 }
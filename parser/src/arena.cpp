@@ -0,0 +1,90 @@
+#include "../include/arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace parser {
+
+    static constexpr size_t block_size = 64 * 1024;
+
+    Arena::Arena() {
+        this->cursor = nullptr;
+        this->remaining = 0;
+    }
+
+    Arena::Arena(Arena&& other) noexcept {
+        this->blocks = std::move(other.blocks);
+        this->cursor = std::exchange(other.cursor, nullptr);
+        this->remaining = std::exchange(other.remaining, 0);
+        other.blocks.clear();
+    }
+
+    Arena& Arena::operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            blocks = std::move(other.blocks);
+            cursor = std::exchange(other.cursor, nullptr);
+            remaining = std::exchange(other.remaining, 0);
+            other.blocks.clear();
+        }
+
+        return *this;
+    }
+
+    void Arena::grow(const size_t min_size) {
+        const size_t size = std::max(block_size, min_size);
+
+        blocks.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+        cursor = blocks.back().get();
+        remaining = size;
+    }
+
+    void* Arena::allocate(const size_t size, const size_t align) {
+        size_t padding = -reinterpret_cast<uintptr_t>(cursor) & (align - 1);
+
+        if (size + padding > remaining) {
+            grow(size + align);
+            padding = -reinterpret_cast<uintptr_t>(cursor) & (align - 1);
+        }
+
+        std::byte* ptr = cursor + padding;
+        cursor = ptr + size;
+        remaining -= size + padding;
+
+        return ptr;
+    }
+
+    std::string_view Arena::copy_string(const std::string_view str) {
+        if (str.empty()) {
+            return {};
+        }
+
+        auto* data = static_cast<char*>(allocate(str.length(), 1));
+        std::memcpy(data, str.data(), str.length());
+
+        return { data, str.length() };
+    }
+
+    void Arena::adopt(Arena&& other) {
+        // Keep our own block first so allocation carries on where it was
+        for (auto& block : other.blocks) {
+            blocks.push_back(std::move(block));
+        }
+
+        other.blocks.clear();
+        other.cursor = nullptr;
+        other.remaining = 0;
+    }
+
+    void Arena::reset() {
+        // Keep the first block around for reuse, drop the rest
+        if (blocks.size() > 1) {
+            blocks.resize(1);
+        }
+
+        cursor = blocks.empty() ? nullptr : blocks.front().get();
+        remaining = blocks.empty() ? 0 : block_size;
+    }
+
+}
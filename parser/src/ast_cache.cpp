@@ -0,0 +1,233 @@
+#include "../include/ast_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "../../cache/include/cache_file.hpp"
+#include "../../cache/include/hash.hpp"
+#include "../../lexer/include/interner.hpp"
+
+namespace parser {
+
+    // Bump the version whenever ASTNode, a node enum or the layout below changes
+    static constexpr cache::EntryTag ast_cache_tag = { { 'C', 'H', 'A', 'C' }, 2 };
+
+    static_assert(std::is_trivially_copyable_v<ASTNode> && sizeof(ASTNode) == 12);
+
+    // File layout, every section follows the previous one unpadded:
+    //   CacheHeader
+    //   ASTNode[node_count]
+    //   NodeId[statement_count]
+    //   uint32_t[string_count + 1]   string offsets into the string bytes
+    //   uint32_t[symbol_count + 1]   spelling offsets into the symbol bytes
+    //   char[string_bytes]
+    //   char[symbol_bytes]
+    struct CacheHeader {
+        cache::EntryHeader entry;
+        uint64_t source_hash;
+        uint64_t source_length;
+        uint64_t source_checksum;
+        uint32_t node_count;
+        uint32_t statement_count;
+        uint32_t string_count;
+        uint32_t symbol_count;
+        uint32_t string_bytes;
+        uint32_t symbol_bytes;
+    };
+
+    static size_t cache_file_size(const CacheHeader& header) {
+        return sizeof(CacheHeader) +
+            static_cast<size_t>(header.node_count) * sizeof(ASTNode) +
+            static_cast<size_t>(header.statement_count) * sizeof(NodeId) +
+            (static_cast<size_t>(header.string_count) + 1) * sizeof(uint32_t) +
+            (static_cast<size_t>(header.symbol_count) + 1) * sizeof(uint32_t) +
+            header.string_bytes +
+            header.symbol_bytes;
+    }
+
+    // Offsets must start at 0, never go backwards and end at the byte count
+    static bool valid_offsets(const std::vector<uint32_t>& offsets, const uint32_t byte_count) {
+        return offsets.front() == 0 &&
+            offsets.back() == byte_count &&
+            std::is_sorted(offsets.begin(), offsets.end());
+    }
+
+    static bool is_expression(const ASTNode& node) {
+        return node.type == STRING_LITERAL || node.type == FLOAT || node.type == INTEGER ||
+            node.type == IDENTIFIER || node.type == BINARY_OP;
+    }
+
+    static bool is_statement(const ASTNode& node) {
+        return node.type == BUILTIN_FUNC || node.type == IMM_DECLARE ||
+            node.type == MUT_DECLARE || node.type == ASSIGN_VAR;
+    }
+
+    // Children always come before their parents, so checking every child
+    // index against its parent's also rules out cycles
+    static bool valid_node(const std::vector<ASTNode>& nodes, const NodeId id, const CacheHeader& header) {
+        const ASTNode& node = nodes[id];
+        const auto expression_child = [&](const uint32_t child) {
+            return child < id && is_expression(nodes[child]);
+        };
+
+        switch (node.type) {
+            case STRING_LITERAL: return node.a < header.string_count;
+            case FLOAT:
+            case INTEGER: return true;
+            case IDENTIFIER: return node.a < header.symbol_count;
+            case BUILTIN_FUNC: return node.op <= lexer::PRINTLN && expression_child(node.a);
+            case IMM_DECLARE:
+            case MUT_DECLARE:
+            case ASSIGN_VAR:
+                return node.a < id && nodes[node.a].type == IDENTIFIER && expression_child(node.b);
+            case BINARY_OP: return node.op <= DIVIDE && expression_child(node.a) && expression_child(node.b);
+        }
+
+        return false;
+    }
+
+    AstCache::AstCache(const std::string& directory, const bool hash_consing) {
+        this->directory = directory;
+        this->hash_consing = hash_consing;
+    }
+
+    std::string AstCache::path_for(const uint64_t source_hash) const {
+        return cache::entry_path(directory, source_hash, hash_consing ? ".hc.ast" : ".ast");
+    }
+
+    std::optional<Program> AstCache::load(const std::string_view source) const {
+        const uint64_t source_hash = cache::hash_bytes(source);
+        CacheHeader header{};
+        const auto file = cache::open_entry(path_for(source_hash), ast_cache_tag, &header, sizeof(header));
+
+        if (!file) {
+            return std::nullopt;
+        }
+
+        const std::string_view bytes = file->view();
+
+        if (
+            header.source_hash != source_hash ||
+            header.source_length != source.length() ||
+            header.source_checksum != cache::checksum(source) ||
+            bytes.length() != cache_file_size(header)
+        ) {
+            return std::nullopt;
+        }
+
+        const char* cursor = bytes.data() + sizeof(CacheHeader);
+
+        const auto take = [&cursor](void* dest, const size_t size) {
+            std::memcpy(dest, cursor, size);
+            cursor += size;
+        };
+
+        Program program;
+
+        program.nodes.resize(header.node_count);
+        take(program.nodes.data(), program.nodes.size() * sizeof(ASTNode));
+
+        program.statements.resize(header.statement_count);
+        take(program.statements.data(), program.statements.size() * sizeof(NodeId));
+
+        std::vector<uint32_t> string_offsets(header.string_count + 1);
+        take(string_offsets.data(), string_offsets.size() * sizeof(uint32_t));
+
+        std::vector<uint32_t> symbol_offsets(header.symbol_count + 1);
+        take(symbol_offsets.data(), symbol_offsets.size() * sizeof(uint32_t));
+
+        if (!valid_offsets(string_offsets, header.string_bytes) || !valid_offsets(symbol_offsets, header.symbol_bytes)) {
+            return std::nullopt;
+        }
+
+        for (NodeId id = 0; id < header.node_count; id++) {
+            if (!valid_node(program.nodes, id, header)) {
+                return std::nullopt;
+            }
+        }
+
+        for (const NodeId stmt : program.statements) {
+            if (stmt >= header.node_count || !is_statement(program.nodes[stmt])) {
+                return std::nullopt;
+            }
+        }
+
+        const std::string_view string_bytes(cursor, header.string_bytes);
+        const std::string_view symbol_bytes(cursor + header.string_bytes, header.symbol_bytes);
+
+        // Stored SymbolIds are only valid if interning the spellings in order
+        // hands out the very same ids, which holds for a fresh interner
+        for (uint32_t i = 0; i < header.symbol_count; i++) {
+            const std::string_view name = symbol_bytes.substr(
+                symbol_offsets[i], symbol_offsets[i + 1] - symbol_offsets[i]
+            );
+
+            if (lexer::intern(name) != i) {
+                return std::nullopt;
+            }
+        }
+
+        // One copy for all literals, the table then just slices it
+        const std::string_view strings = program.arena.copy_string(string_bytes);
+        program.strings.reserve(header.string_count);
+
+        for (uint32_t i = 0; i < header.string_count; i++) {
+            program.strings.push_back(strings.substr(
+                string_offsets[i], string_offsets[i + 1] - string_offsets[i]
+            ));
+        }
+
+        return program;
+    }
+
+    void AstCache::store(const std::string_view source, const Program& program) const {
+        lexer::SymbolId symbol_count = 0;
+
+        for (const ASTNode& node : program.nodes) {
+            if (node.type == IDENTIFIER) {
+                symbol_count = std::max(symbol_count, node.a + 1);
+            }
+        }
+
+        std::vector<uint32_t> string_offsets{ 0 };
+        std::string string_bytes;
+
+        for (const std::string_view str : program.strings) {
+            string_bytes += str;
+            string_offsets.push_back(static_cast<uint32_t>(string_bytes.length()));
+        }
+
+        // Every id below the highest one used, so reloading reproduces them all
+        std::vector<uint32_t> symbol_offsets{ 0 };
+        std::string symbol_bytes;
+
+        for (lexer::SymbolId id = 0; id < symbol_count; id++) {
+            symbol_bytes += lexer::symbol_name(id);
+            symbol_offsets.push_back(static_cast<uint32_t>(symbol_bytes.length()));
+        }
+
+        CacheHeader header{};
+        header.entry.tag = ast_cache_tag;
+        header.source_hash = cache::hash_bytes(source);
+        header.source_length = source.length();
+        header.source_checksum = cache::checksum(source);
+        header.node_count = static_cast<uint32_t>(program.nodes.size());
+        header.statement_count = static_cast<uint32_t>(program.statements.size());
+        header.string_count = static_cast<uint32_t>(program.strings.size());
+        header.symbol_count = symbol_count;
+        header.string_bytes = static_cast<uint32_t>(string_bytes.length());
+        header.symbol_bytes = static_cast<uint32_t>(symbol_bytes.length());
+
+        cache::write_entry(path_for(header.source_hash), &header, sizeof(header), {
+            { program.nodes.data(), program.nodes.size() * sizeof(ASTNode) },
+            { program.statements.data(), program.statements.size() * sizeof(NodeId) },
+            { string_offsets.data(), string_offsets.size() * sizeof(uint32_t) },
+            { symbol_offsets.data(), symbol_offsets.size() * sizeof(uint32_t) },
+            { string_bytes.data(), string_bytes.length() },
+            { symbol_bytes.data(), symbol_bytes.length() }
+        });
+    }
+
+}
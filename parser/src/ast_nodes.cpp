@@ -1,4 +1,8 @@
 #include "../include/ast_nodes.hpp"
+
+#include <bit>
+#include <cassert>
+
 #include "../include/parse_error.hpp"
 
 namespace parser {
@@ -15,6 +19,7 @@ namespace parser {
             case IDENTIFIER: return "IDENTIFIER";
             case BUILTIN_FUNC: return "BUILTIN_FUNC";
             case IMM_DECLARE: return "IMM_DECLARE";
+            case MUT_DECLARE: return "MUT_DECLARE";
             case ASSIGN_VAR: return "ASSIGN_VAR";
             case BINARY_OP: return "BINARY_OP";
             default: {
@@ -23,169 +28,268 @@ namespace parser {
         }
     }
 
-    BuiltInFunc::BuiltInFunc(const std::string& func_name, std::unique_ptr<ASTNode> arg) {
-        this->func_name = func_name;
-        this->arg = std::move(arg);
-        this->type = BUILTIN_FUNC;
+    NodeId Program::push(const ASTValueType type, const uint8_t op, const uint32_t a, const uint32_t b) {
+        nodes.push_back({ type, op, a, b });
+        return static_cast<NodeId>(nodes.size() - 1);
     }
 
-    void BuiltInFunc::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "BuiltInFunc: " << func_name << "\n";
+    NodeId Program::push_shared(const ASTValueType type, const uint8_t op, const uint32_t a, const uint32_t b) {
+        if (!hash_consing) {
+            return push(type, op, a, b);
+        }
+
+        const auto [it, inserted] = shared_nodes.try_emplace({ type, op, a, b }, static_cast<NodeId>(nodes.size()));
 
-        if (arg) {
-            arg->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Arg value is null\n";
+        if (inserted) {
+            nodes.push_back({ type, op, a, b });
         }
+
+        return it->second;
     }
 
-    StringLiteral::StringLiteral(const std::string& content) {
-        this->content = content;
-        this->type = STRING_LITERAL;
+    void Program::enable_hash_consing() {
+        hash_consing = true;
     }
 
-    void StringLiteral::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "StringLiteral: \"" << content << "\"\n";
+    NodeId Program::add_string_literal(const std::string_view content) {
+        if (hash_consing) {
+            if (const auto it = shared_strings.find(content); it != shared_strings.end()) {
+                return push_shared(STRING_LITERAL, 0, it->second, 0);
+            }
+        }
+
+        strings.push_back(arena.copy_string(content));
+        const auto index = static_cast<uint32_t>(strings.size() - 1);
+
+        if (hash_consing) {
+            shared_strings.emplace(strings.back(), index);
+        }
+
+        return push_shared(STRING_LITERAL, 0, index, 0);
     }
 
-    Integer::Integer(const int value) {
-        this->value = value;
-        this->type = INTEGER;
+    NodeId Program::add_integer(const int value) {
+        return push_shared(INTEGER, 0, static_cast<uint32_t>(value), 0);
     }
 
-    void Integer::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "Integer: " << value << "\n";
+    NodeId Program::add_float(const float value) {
+        return push_shared(FLOAT, 0, std::bit_cast<uint32_t>(value), 0);
     }
 
-    Float::Float(const float value) {
-        this->value = value;
-        this->type = FLOAT;
+    NodeId Program::add_identifier(const lexer::SymbolId symbol) {
+        return push_shared(IDENTIFIER, 0, symbol, 0);
     }
 
-    void Float::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "Float: " << value << "\n";
+    NodeId Program::add_builtin_func(const lexer::DefinedFunction func, const NodeId arg) {
+        return push(BUILTIN_FUNC, func, arg, 0);
     }
 
-    Identifier::Identifier(const std::string& name) {
-        this->name = name;
-        this->type = IDENTIFIER;
+    NodeId Program::add_imm_declare(const NodeId identifier, const NodeId value) {
+        return push(IMM_DECLARE, 0, identifier, value);
     }
 
-    void Identifier::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "Identifier: " << name << "\n";
+    NodeId Program::add_mut_declare(const NodeId identifier, const NodeId value) {
+        return push(MUT_DECLARE, 0, identifier, value);
     }
 
-    ImmDeclare::ImmDeclare(std::unique_ptr<ASTNode> identifier, std::unique_ptr<ASTNode> value) {
-        this->identifier = std::move(identifier);
-        this->value = std::move(value);
-        this->type = IMM_DECLARE;
+    NodeId Program::add_assign_var(const NodeId identifier, const NodeId value) {
+        return push(ASSIGN_VAR, 0, identifier, value);
     }
 
-    void ImmDeclare::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "ImmDeclare:\n";
+    NodeId Program::add_binary_op(const NodeId left, const NodeId right, const BinaryOperator op) {
+        return push_shared(BINARY_OP, op, left, right);
+    }
+
+    void Program::add_statement(const NodeId stmt) {
+        statements.push_back(stmt);
+    }
+
+    void Program::append(Program&& other) {
+        const auto node_shift = static_cast<uint32_t>(nodes.size());
+        const auto string_shift = static_cast<uint32_t>(strings.size());
+
+        nodes.reserve(nodes.size() + other.nodes.size());
+
+        for (ASTNode node : other.nodes) {
+            switch (node.type) {
+                case STRING_LITERAL:
+                    node.a += string_shift;
+                    break;
+                case FLOAT:
+                case INTEGER:
+                case IDENTIFIER:
+                    break;
+                case BUILTIN_FUNC:
+                    node.a += node_shift;
+                    break;
+                case IMM_DECLARE:
+                case MUT_DECLARE:
+                case ASSIGN_VAR:
+                case BINARY_OP:
+                    node.a += node_shift;
+                    node.b += node_shift;
+                    break;
+            }
+
+            // Nodes already shared with ours stay duplicated, but later
+            // additions can still share with the appended ones
+            if (hash_consing && node.type != BUILTIN_FUNC && node.type != IMM_DECLARE &&
+                node.type != MUT_DECLARE && node.type != ASSIGN_VAR) {
+                shared_nodes.try_emplace(node, static_cast<NodeId>(nodes.size()));
+            }
+
+            nodes.push_back(node);
+        }
 
-        if (identifier) {
-            identifier->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Identifier value is null\n";
+        // The views keep pointing into other's arena blocks, which we now own
+        for (const std::string_view str : other.strings) {
+            if (hash_consing) {
+                shared_strings.try_emplace(str, static_cast<uint32_t>(strings.size()));
+            }
+
+            strings.push_back(str);
         }
 
-        if (value) {
-            value->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Value is null\n";
+        arena.adopt(std::move(other.arena));
+
+        for (const NodeId stmt : other.statements) {
+            statements.push_back(stmt + node_shift);
         }
+
+        other.nodes.clear();
+        other.strings.clear();
+        other.statements.clear();
+        other.shared_nodes.clear();
+        other.shared_strings.clear();
     }
 
-    MutDeclare::MutDeclare(std::unique_ptr<ASTNode> identifier, std::unique_ptr<ASTNode> value) {
-        this->identifier = std::move(identifier);
-        this->value = std::move(value);
-        this->type = MUT_DECLARE;
+    const std::vector<NodeId>& Program::get_statements() const {
+        return statements;
     }
 
-    void MutDeclare::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "MutDeclare:\n";
+    size_t Program::size() const {
+        return nodes.size();
+    }
 
-        if (identifier) {
-            identifier->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Identifier value is null\n";
-        }
+    ASTValueType Program::type(const NodeId id) const {
+        return nodes[id].type;
+    }
 
-        if (value) {
-            value->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Value is null\n";
-        }
+    std::string_view Program::string_value(const NodeId id) const {
+        assert(nodes[id].type == STRING_LITERAL);
+        return strings[nodes[id].a];
     }
 
-    AssignVar::AssignVar(std::unique_ptr<ASTNode> identifier, std::unique_ptr<ASTNode> value) {
-        this->identifier = std::move(identifier);
-        this->value = std::move(value);
-        this->type = ASSIGN_VAR;
+    int Program::integer_value(const NodeId id) const {
+        assert(nodes[id].type == INTEGER);
+        return static_cast<int>(nodes[id].a);
     }
 
-    void AssignVar::print(std::ostream& os, const int indent_level) const {
-        indent(os, indent_level);
-        os << "AssignVar:\n";
+    float Program::float_value(const NodeId id) const {
+        assert(nodes[id].type == FLOAT);
+        return std::bit_cast<float>(nodes[id].a);
+    }
 
-        if (identifier) {
-            identifier->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Identifier value is null\n";
-        }
+    lexer::SymbolId Program::symbol(const NodeId id) const {
+        assert(nodes[id].type == IDENTIFIER);
+        return nodes[id].a;
+    }
 
-        if (value) {
-            value->print(os, indent_level + 1);
-        } else {
-            indent(os, indent_level + 1);
-            os << "Value is null\n";
-        }
+    lexer::DefinedFunction Program::func(const NodeId id) const {
+        assert(nodes[id].type == BUILTIN_FUNC);
+        return static_cast<lexer::DefinedFunction>(nodes[id].op);
+    }
+
+    NodeId Program::arg(const NodeId id) const {
+        assert(nodes[id].type == BUILTIN_FUNC);
+        return nodes[id].a;
     }
 
-    BinaryOp::BinaryOp(
-        std::unique_ptr<ASTNode> left,
-        std::unique_ptr<ASTNode> right,
-        const BinaryOperator op
-    ) {
-        this->left = std::move(left);
-        this->right = std::move(right);
-        this->op = op;
-        this->type = BINARY_OP;
+    NodeId Program::identifier(const NodeId id) const {
+        assert(nodes[id].type == IMM_DECLARE || nodes[id].type == MUT_DECLARE || nodes[id].type == ASSIGN_VAR);
+        return nodes[id].a;
     }
 
-    void BinaryOp::print(std::ostream& os, const int indent_level) const {
+    NodeId Program::value(const NodeId id) const {
+        assert(nodes[id].type == IMM_DECLARE || nodes[id].type == MUT_DECLARE || nodes[id].type == ASSIGN_VAR);
+        return nodes[id].b;
+    }
+
+    BinaryOperator Program::op(const NodeId id) const {
+        assert(nodes[id].type == BINARY_OP);
+        return static_cast<BinaryOperator>(nodes[id].op);
+    }
+
+    NodeId Program::left(const NodeId id) const {
+        assert(nodes[id].type == BINARY_OP);
+        return nodes[id].a;
+    }
+
+    NodeId Program::right(const NodeId id) const {
+        assert(nodes[id].type == BINARY_OP);
+        return nodes[id].b;
+    }
+
+    void Program::print(std::ostream& os, const NodeId id, const int indent_level) const {
         indent(os, indent_level);
-        os << "BinaryOp:\n";
-
-        if (op) {
-            indent(os, indent_level + 1);
-            os << "Operator: " << binary_operator_to_str(op) << "\n";
-        } else {
-            indent(os, indent_level + 1);
-            os << "Operator is null\n";
-        }
 
-        indent(os, indent_level + 1);
-        os << "Left Type: " << ast_val_type_str(left->type) << "\n";
-        left->print(os, indent_level + 1);
+        switch (type(id)) {
+            case STRING_LITERAL: {
+                os << "StringLiteral: \"" << string_value(id) << "\"\n";
+            } break;
+
+            case INTEGER: {
+                os << "Integer: " << integer_value(id) << "\n";
+            } break;
+
+            case FLOAT: {
+                os << "Float: " << float_value(id) << "\n";
+            } break;
+
+            case IDENTIFIER: {
+                os << "Identifier: " << lexer::symbol_name(symbol(id)) << "\n";
+            } break;
+
+            case BUILTIN_FUNC: {
+                os << "BuiltInFunc: " << lexer::defined_function_name(func(id)) << "\n";
+                print(os, arg(id), indent_level + 1);
+            } break;
+
+            case IMM_DECLARE:
+            case MUT_DECLARE:
+            case ASSIGN_VAR: {
+                if (type(id) == IMM_DECLARE) os << "ImmDeclare:\n";
+                else if (type(id) == MUT_DECLARE) os << "MutDeclare:\n";
+                else os << "AssignVar:\n";
+
+                print(os, identifier(id), indent_level + 1);
+                print(os, value(id), indent_level + 1);
+            } break;
+
+            case BINARY_OP: {
+                os << "BinaryOp:\n";
+
+                indent(os, indent_level + 1);
+                os << "Operator: " << binary_operator_to_str(op(id)) << "\n";
+
+                indent(os, indent_level + 1);
+                os << "Left Type: " << ast_val_type_str(type(left(id))) << "\n";
+                print(os, left(id), indent_level + 1);
+
+                indent(os, indent_level + 1);
+                os << "Right Type: " << ast_val_type_str(type(right(id))) << "\n";
+                print(os, right(id), indent_level + 1);
+            } break;
+        }
+    }
 
-        indent(os, indent_level + 1);
-        os << "Right Type: " << ast_val_type_str(left->type) << "\n";
-        right->print(os, indent_level + 1);
+    void Program::clear() {
+        nodes.clear();
+        strings.clear();
+        statements.clear();
+        shared_nodes.clear();
+        shared_strings.clear();
+        arena.reset();
     }
 
 }
@@ -5,16 +5,7 @@
 namespace parser {
 
     bool is_binary_op(const lexer::TokenType type) {
-        switch (type) {
-            case lexer::ADD:
-            case lexer::SUBTRACT:
-            case lexer::MULTIPLY:
-            case lexer::DIVIDE:
-                return true;
-
-            default:
-                return false;
-        }
+        return binary_operator_info(type).precedence != 0;
     }
 
     std::string binary_operator_to_str(const BinaryOperator op) {
@@ -1,24 +1,24 @@
-#include <regex>
+#include <charconv>
 
 #include "../include/parser.hpp"
-#include "../include/defined_functions.hpp"
 #include "../include/parse_error.hpp"
+#include "../../lexer/include/chunk_runner.hpp"
 
 namespace parser {
 
-    const lexer::Token& Parser::peek() const {
-        return tokens[index];
+    lexer::TokenType Parser::peek() const {
+        return tokens.type(index);
     }
 
-    const lexer::Token& Parser::backPeek() const {
-        return tokens[index - 1];
+    size_t Parser::backPeek() const {
+        return index - 1;
     }
 
     bool Parser::is_at_end() const {
-        return index >= tokens.size();
+        return index >= end;
     }
 
-    const lexer::Token& Parser::consume() {
+    size_t Parser::consume() {
         if (!is_at_end()) {
             index++;
         }
@@ -31,11 +31,11 @@ namespace parser {
     }
 
     bool Parser::check(const lexer::TokenType type) const {
-        return peek().type == type;
+        return peek() == type;
     }
 
-    const lexer::Token& Parser::expect(const lexer::TokenType type, const std::string& err_msg) {
-        if (peek().type != type) {
+    size_t Parser::expect(const lexer::TokenType type, const std::string& err_msg) {
+        if (peek() != type) {
             throw ParseError(err_msg);
         }
 
@@ -43,195 +43,252 @@ namespace parser {
     }
 
     void Parser::expect_symbol(const lexer::TokenType type, const std::string& err_msg) {
-        if (consume().type != type) {
+        if (tokens.type(consume()) != type) {
             throw ParseError(err_msg);
         }
     }
 
-    std::unique_ptr<ASTNode> Parser::build_factor() {
-        if (peek().type == lexer::LEFT_PAREN) {
-            advance();
-            auto expr = build_expr();
-
-            expect_symbol(lexer::RIGHT_PAREN, "Expected closing parenthesis in factor.");
-
-            advance();
-            return expr;
+    NodeId Parser::build_operand() {
+        if (is_at_end()) {
+            throw ParseError("Unexpected end of input in expression.");
         }
 
-        switch (peek().type) {
+        switch (peek()) {
             case lexer::STRING_LITERAL: {
-                const std::string& content = consume().value;
-                return std::make_unique<StringLiteral>(content);
+                return program.add_string_literal(tokens.text(consume()));
             }
 
             case lexer::FLOAT: {
+                const std::string_view text = tokens.text(consume());
                 float val;
 
-                try {
-                    val = std::stof(consume().value);
-                } catch (const std::invalid_argument& _) {
-                    throw ParseError("Invalid float value: '" + backPeek().value + "'.");
-                } catch (const std::out_of_range& _) {
+                const auto [end, ec] = std::from_chars(text.data(), text.data() + text.length(), val);
+
+                if (ec == std::errc::result_out_of_range) {
                     throw ParseError("Value is out of range for float.");
                 }
 
-                return std::make_unique<Float>(val);
+                if (ec != std::errc() || end != text.data() + text.length()) {
+                    throw ParseError("Invalid float value: '" + std::string(text) + "'.");
+                }
+
+                return program.add_float(val);
             }
 
             case lexer::INTEGER: {
+                const std::string_view text = tokens.text(consume());
                 int val;
 
-                try {
-                    val = std::stoi(consume().value);
-                } catch (const std::invalid_argument& _) {
-                    throw ParseError("Invalid integer value: '" + backPeek().value + "'.");
-                } catch (const std::out_of_range& _) {
+                const auto [end, ec] = std::from_chars(text.data(), text.data() + text.length(), val);
+
+                if (ec == std::errc::result_out_of_range) {
                     throw ParseError("Value is out of range for integer.");
                 }
 
-                return std::make_unique<Integer>(val);
+                if (ec != std::errc() || end != text.data() + text.length()) {
+                    throw ParseError("Invalid integer value: '" + std::string(text) + "'.");
+                }
+
+                return program.add_integer(val);
             }
 
             case lexer::IDENTIFIER: {
-                const std::string& content = consume().value;
-                return std::make_unique<Identifier>(content);
+                return program.add_identifier(tokens.symbol(consume()));
             }
 
             default:
-                throw ParseError("Unexpected token in build factor.");
+                throw ParseError("Unexpected token in expression.");
         }
     }
 
-    std::unique_ptr<ASTNode> Parser::build_term() {
-        auto left = build_factor();
+    void Parser::reduce_operator() {
+        const BinaryOperator op = operator_stack.back().op;
+        operator_stack.pop_back();
 
-        while (!is_at_end()) {
-            BinaryOperator op;
+        const NodeId right = operand_stack.back();
+        operand_stack.pop_back();
 
-            if (peek().type == lexer::MULTIPLY) {
-                op = BinaryOperator::MULTIPLY;
-            } else if (peek().type == lexer::DIVIDE) {
-                op = BinaryOperator::DIVIDE;
-            } else {
-                break;
+        operand_stack.back() = program.add_binary_op(operand_stack.back(), right, op);
+    }
+
+    // Operator precedence parsing with explicit stacks: one iteration per
+    // operand and operator, so nesting depth is only bounded by memory
+    NodeId Parser::build_expr() {
+        operand_stack.clear();
+        operator_stack.clear();
+
+        size_t open_parens = 0;
+
+        while (true) {
+            while (!is_at_end() && peek() == lexer::LEFT_PAREN) {
+                operator_stack.push_back({ ADD, 0 });
+                open_parens++;
+                advance();
             }
 
-            advance();
-            auto right = build_factor();
+            operand_stack.push_back(build_operand());
 
-            left = std::make_unique<BinaryOp>(
-                std::move(left), std::move(right), op
-            );
-        }
+            while (open_parens > 0 && !is_at_end() && peek() == lexer::RIGHT_PAREN) {
+                while (operator_stack.back().precedence != 0) {
+                    reduce_operator();
+                }
 
-        return left;
-    }
+                operator_stack.pop_back();
+                open_parens--;
+                advance();
+            }
 
-    std::unique_ptr<ASTNode> Parser::build_expr() {
-        auto left = build_term();
+            if (is_at_end()) {
+                break;
+            }
 
-        while (!is_at_end()) {
-            BinaryOperator op;
+            const OperatorInfo& info = binary_operator_info(peek());
 
-            if (peek().type == lexer::ADD) {
-                op = BinaryOperator::ADD;
-            } else if (peek().type == lexer::SUBTRACT) {
-                op = BinaryOperator::SUBTRACT;
-            } else {
+            if (info.precedence == 0) {
                 break;
             }
 
+            // All operators are left associative, so equal precedence reduces first
+            while (!operator_stack.empty() && operator_stack.back().precedence >= info.precedence) {
+                reduce_operator();
+            }
+
+            operator_stack.push_back(info);
             advance();
-            auto right = build_term();
+        }
+
+        if (open_parens > 0) {
+            throw ParseError("Expected closing parenthesis in expression.");
+        }
 
-            left = std::make_unique<BinaryOp>(
-                std::move(left), std::move(right), op
-            );
+        while (!operator_stack.empty()) {
+            reduce_operator();
         }
 
-        return left;
+        return operand_stack.back();
     }
 
-    std::unique_ptr<ASTNode> Parser::build_imm_declare() {
+    NodeId Parser::build_imm_declare() {
         auto identifier_token = expect(lexer::IDENTIFIER,
             "Expected valid identifier in immutable declaration.");
 
-        auto identifier = std::make_unique<Identifier>(identifier_token.value);
+        auto identifier = program.add_identifier(tokens.symbol(identifier_token));
         expect_symbol(lexer::EQUALS, "Unexpected token in build immutable declaration.");
 
         auto expr = build_expr();
-        return std::make_unique<ImmDeclare>(std::move(identifier), std::move(expr));
+        return program.add_imm_declare(identifier, expr);
     }
 
-    std::unique_ptr<ASTNode> Parser::build_mut_declare() {
+    NodeId Parser::build_mut_declare() {
         auto identifier_token = expect(lexer::IDENTIFIER,
      "Expected valid identifier in mutable declaration.");
 
-        auto identifier = std::make_unique<Identifier>(identifier_token.value);
+        auto identifier = program.add_identifier(tokens.symbol(identifier_token));
         expect_symbol(lexer::EQUALS, "Unexpected token in build mutable declaration.");
 
         auto expr = build_expr();
-        return std::make_unique<MutDeclare>(std::move(identifier), std::move(expr));
+        return program.add_mut_declare(identifier, expr);
     }
 
-    std::unique_ptr<ASTNode> Parser::build_assign_var() {
+    NodeId Parser::build_assign_var() {
         auto identifier_token = expect(lexer::IDENTIFIER,
             "Expected valid identifier in value assignment statement.");
 
-        auto identifier = std::make_unique<Identifier>(identifier_token.value);
+        auto identifier = program.add_identifier(tokens.symbol(identifier_token));
         expect_symbol(lexer::EQUALS, "Unexpected token in build assignment statement.");
 
         auto expr = build_expr();
-        return std::make_unique<AssignVar>(std::move(identifier), std::move(expr));
+        return program.add_assign_var(identifier, expr);
     }
 
-    std::unique_ptr<ASTNode> Parser::build_builtin_func_call() {
-        if (!defined_functions.contains(peek().value)) {
-            throw ParseError("Builtin function '" + peek().value + "' unidentified.");
-        }
+    NodeId Parser::build_builtin_func_call() {
+        const auto func = static_cast<lexer::DefinedFunction>(tokens.payload(consume()));
 
-        auto func_name = consume().value;
         auto expr = build_expr();
-        return std::make_unique<BuiltInFunc>(std::move(func_name), std::move(expr));
+        return program.add_builtin_func(func, expr);
     }
 
-    std::unique_ptr<ASTNode> Parser::build_statement() {
-        std::unique_ptr<ASTNode> stmt;
+    NodeId Parser::build_statement() {
+        NodeId stmt;
 
-        if (peek().type == lexer::KEYWORD) {
-            if (peek().value == "dec") {
+        switch (peek()) {
+            case lexer::KW_DEC: {
                 advance();
                 stmt = build_imm_declare();
-            } else if (peek().value == "decm") {
+            } break;
+
+            case lexer::KW_DECM: {
                 advance();
                 stmt = build_mut_declare();
-            } else {
-                throw ParseError("Unidentified keyword found.");
-            }
-        } else if (peek().type == IDENTIFIER) {
-            stmt = build_assign_var();
-        } else if (peek().type == BUILTIN_FUNC) {
-            stmt = build_builtin_func_call();
-        } else {
-            throw ParseError("Unexpected token in build statement.");
+            } break;
+
+            case lexer::IDENTIFIER: {
+                stmt = build_assign_var();
+            } break;
+
+            case lexer::BUILTIN_FUNC: {
+                stmt = build_builtin_func_call();
+            } break;
+
+            default:
+                throw ParseError("Unexpected token in build statement.");
         }
 
         expect_symbol(lexer::LINE_END, "Expected line end after statement.");
         return stmt;
     }
 
-    Parser::Parser(const std::vector<lexer::Token>& tokens)
-        : tokens(tokens), index(0) {}
+    void Parser::build_statements() {
+        while (!is_at_end()) {
+            program.add_statement(build_statement());
+        }
+    }
 
-    std::vector<std::unique_ptr<ASTNode>> Parser::build_program() {
-        std::vector<std::unique_ptr<ASTNode>> program{};
+    // Below this many tokens a single thread parses faster than a pool
+    static constexpr size_t min_chunk_tokens = 1 << 17;
 
-        while (!is_at_end()) {
-            program.emplace_back(build_statement());
+    Program Parser::build_chunks(const size_t count) const {
+        // Statements never span a LINE_END, so chunks start right after one
+        const std::vector<size_t> bounds = lexer::chunk_bounds(index, end, count, [&](const size_t target) {
+            return tokens.find(lexer::LINE_END, target);
+        });
+
+        const size_t chunks = bounds.size() - 1;
+        std::vector<Program> results(chunks);
+
+        // Each chunk stops at its own first error
+        lexer::run_chunks(bounds, [&](const size_t i) {
+            Parser worker(tokens, hash_consing);
+            worker.index = bounds[i];
+            worker.end = bounds[i + 1];
+            worker.build_statements();
+
+            results[i] = std::move(worker.program);
+        });
+
+        Program merged = std::move(results.front());
+
+        for (size_t i = 1; i < chunks; i++) {
+            merged.append(std::move(results[i]));
+        }
+
+        return merged;
+    }
+
+    Parser::Parser(const lexer::TokenBuffer& tokens, const bool hash_consing)
+        : tokens(tokens), index(0), end(tokens.size()), hash_consing(hash_consing) {
+        if (hash_consing) {
+            program.enable_hash_consing();
+        }
+    }
+
+    Program Parser::build_program() {
+        if (const size_t count = lexer::chunk_count(end - index, min_chunk_tokens); count > 1) {
+            return build_chunks(count);
         }
 
-        return program;
+        build_statements();
+        return std::move(program);
     }
 
 }
@@ -0,0 +1,56 @@
+#ifndef SEMA_HPP
+#define SEMA_HPP
+
+#include <utility>
+#include <vector>
+
+#include "symbol_table.hpp"
+#include "../../parser/include/ast_nodes.hpp"
+
+namespace sema {
+
+    // What sema resolved, indexed by NodeId. Only covers the nodes that
+    // existed when the program was analysed.
+    class Annotations {
+        std::vector<parser::ASTValueType> types;
+        std::vector<SlotId> slots;
+        SymbolTable symbols;
+
+        friend class Sema;
+
+    public:
+        // Value type of an expression node: literals are their own type,
+        // identifiers their variable's type, binary ops their result type
+        [[nodiscard]] parser::ASTValueType type(parser::NodeId node) const;
+
+        [[nodiscard]] SlotId slot(parser::NodeId identifier) const;
+        [[nodiscard]] const Symbol& symbol(parser::NodeId identifier) const;
+
+        [[nodiscard]] const SymbolTable& symbol_table() const;
+    };
+
+    // Resolves every identifier to its declaration and type checks the
+    // program, statement by statement in source order.
+    class Sema {
+        const parser::Program& program;
+        Annotations annotations;
+
+        // Pending expression nodes, true once their operands are pushed
+        std::vector<std::pair<parser::NodeId, bool>> stack;
+
+        void resolve_identifier(parser::NodeId identifier);
+        void resolve_expr(parser::NodeId root);
+
+        void check_declare(parser::NodeId identifier, parser::NodeId value, bool muttable);
+        void check_assign_var(parser::NodeId identifier, parser::NodeId value);
+        void check_statement(parser::NodeId stmt);
+
+    public:
+        explicit Sema(const parser::Program& program);
+
+        Annotations analyze();
+    };
+
+}
+
+#endif //SEMA_HPP
@@ -0,0 +1,22 @@
+#ifndef SEMA_ERROR_HPP
+#define SEMA_ERROR_HPP
+
+#include <exception>
+#include <string>
+
+namespace sema {
+
+    class SemaError final : public std::exception {
+        std::string message;
+
+        mutable std::string formatted_msg;
+
+    public:
+        explicit SemaError(const std::string& msg);
+
+        const char* what() const noexcept override;
+    };
+
+}
+
+#endif //SEMA_ERROR_HPP
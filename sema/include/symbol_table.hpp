@@ -0,0 +1,47 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "../../lexer/include/interner.hpp"
+#include "../../parser/include/ast_nodes.hpp"
+
+namespace sema {
+
+    // Dense index of a declared variable, in declaration order
+    using SlotId = uint32_t;
+
+    inline constexpr SlotId no_slot = UINT32_MAX;
+
+    struct Symbol {
+        lexer::SymbolId name;
+        parser::ASTValueType type;
+        bool muttable;
+    };
+
+    // Maps a variable's SymbolId to its slot. Linear probing over a flat
+    // power-of-two bucket array, kept at most half full.
+    class SymbolTable {
+        std::vector<SlotId> buckets;
+        std::vector<Symbol> symbols;
+
+        [[nodiscard]] size_t bucket_of(lexer::SymbolId name) const;
+        void grow();
+
+    public:
+        SymbolTable();
+
+        // no_slot if name isn't declared
+        [[nodiscard]] SlotId find(lexer::SymbolId name) const;
+
+        // symbol.name must not be declared yet
+        SlotId insert(const Symbol& symbol);
+
+        [[nodiscard]] const Symbol& operator[](SlotId slot) const;
+        [[nodiscard]] size_t size() const;
+    };
+
+}
+
+#endif //SYMBOL_TABLE_HPP
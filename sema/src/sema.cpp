@@ -0,0 +1,184 @@
+#include "../include/sema.hpp"
+
+#include <string>
+
+#include "../include/sema_error.hpp"
+#include "../../parser/include/ast_visitor.hpp"
+
+namespace sema {
+
+    static std::string name_of(const lexer::SymbolId symbol) {
+        return std::string(lexer::symbol_name(symbol));
+    }
+
+    parser::ASTValueType Annotations::type(const parser::NodeId node) const {
+        return types[node];
+    }
+
+    SlotId Annotations::slot(const parser::NodeId identifier) const {
+        return slots[identifier];
+    }
+
+    const Symbol& Annotations::symbol(const parser::NodeId identifier) const {
+        return symbols[slots[identifier]];
+    }
+
+    const SymbolTable& Annotations::symbol_table() const {
+        return symbols;
+    }
+
+    // Same promotion rules the constant folder applies
+    static parser::ASTValueType binary_result_type(
+        const parser::BinaryOperator op,
+        const parser::ASTValueType left,
+        const parser::ASTValueType right
+    ) {
+        if (left == parser::STRING_LITERAL || right == parser::STRING_LITERAL) {
+            if (op != parser::ADD) {
+                throw SemaError("Attempted invalid string binary operation.");
+            }
+
+            return parser::STRING_LITERAL;
+        }
+
+        if (left == parser::FLOAT || right == parser::FLOAT) {
+            return parser::FLOAT;
+        }
+
+        return parser::INTEGER;
+    }
+
+    void Sema::resolve_identifier(const parser::NodeId identifier) {
+        const lexer::SymbolId name = program.symbol(identifier);
+        const SlotId slot = annotations.symbols.find(name);
+
+        if (slot == no_slot) {
+            throw SemaError("Attempted to use undefined variable '" + name_of(name) + "'.");
+        }
+
+        annotations.slots[identifier] = slot;
+        annotations.types[identifier] = annotations.symbols[slot].type;
+    }
+
+    void Sema::resolve_expr(const parser::NodeId root) {
+        // Post-order with an explicit stack, expression depth is unbounded
+        stack.clear();
+        stack.emplace_back(root, false);
+
+        while (!stack.empty()) {
+            const auto [node, expanded] = stack.back();
+            stack.pop_back();
+
+            switch (program.type(node)) {
+                case parser::IDENTIFIER: {
+                    resolve_identifier(node);
+                } break;
+
+                case parser::BINARY_OP: {
+                    // A shared subtree of a hash-consed program is typed once
+                    if (annotations.types[node] != parser::BINARY_OP) {
+                        break;
+                    }
+
+                    if (!expanded) {
+                        stack.emplace_back(node, true);
+                        stack.emplace_back(program.right(node), false);
+                        stack.emplace_back(program.left(node), false);
+                        break;
+                    }
+
+                    annotations.types[node] = binary_result_type(
+                        program.op(node),
+                        annotations.types[program.left(node)],
+                        annotations.types[program.right(node)]
+                    );
+                } break;
+
+                case parser::STRING_LITERAL:
+                case parser::FLOAT:
+                case parser::INTEGER:
+                    break;
+
+                case parser::BUILTIN_FUNC:
+                case parser::IMM_DECLARE:
+                case parser::MUT_DECLARE:
+                case parser::ASSIGN_VAR:
+                    throw SemaError("Statement used as a value.");
+            }
+        }
+    }
+
+    void Sema::check_declare(const parser::NodeId identifier, const parser::NodeId value, const bool muttable) {
+        // The value first, a variable isn't in scope in its own initialiser
+        resolve_expr(value);
+
+        const lexer::SymbolId name = program.symbol(identifier);
+
+        if (annotations.symbols.find(name) != no_slot) {
+            throw SemaError("Variable '" + name_of(name) + "' already declared.");
+        }
+
+        const parser::ASTValueType type = annotations.types[value];
+        const SlotId slot = annotations.symbols.insert(Symbol{ name, type, muttable });
+
+        annotations.slots[identifier] = slot;
+        annotations.types[identifier] = type;
+    }
+
+    void Sema::check_assign_var(const parser::NodeId identifier, const parser::NodeId value) {
+        resolve_expr(value);
+
+        const lexer::SymbolId name = program.symbol(identifier);
+
+        if (annotations.symbols.find(name) == no_slot) {
+            throw SemaError("Attempting to assign an undefined variable with name '" + name_of(name) + "'.");
+        }
+
+        resolve_identifier(identifier);
+        const Symbol& symbol = annotations.symbol(identifier);
+
+        if (!symbol.muttable) {
+            throw SemaError("Attempting to mutate an immutable variable.");
+        }
+
+        const parser::ASTValueType new_type = annotations.types[value];
+
+        if (symbol.type != new_type) {
+            throw SemaError(
+                "Attempted to assign wrong type to variable '" + name_of(name) + "':\n" +
+                parser::ast_val_type_str(symbol.type) + " -> " + parser::ast_val_type_str(new_type)
+            );
+        }
+    }
+
+    void Sema::check_statement(const parser::NodeId stmt) {
+        parser::visit(program, stmt, parser::overloaded{
+            [&](const parser::ImmDeclare& node) { check_declare(node.identifier, node.value, false); },
+            [&](const parser::MutDeclare& node) { check_declare(node.identifier, node.value, true); },
+            [&](const parser::AssignVar& node) { check_assign_var(node.identifier, node.value); },
+            [&](const parser::BuiltInFunc& node) { resolve_expr(node.arg); },
+            [](const auto&) { throw SemaError("Unidentified statement AST."); }
+        });
+    }
+
+    Sema::Sema(const parser::Program& program)
+        : program(program) {}
+
+    Annotations Sema::analyze() {
+        const size_t size = program.size();
+
+        annotations.types.resize(size);
+        annotations.slots.assign(size, no_slot);
+
+        for (parser::NodeId node = 0; node < size; node++) {
+            annotations.types[node] = program.type(node);
+        }
+
+        for (const parser::NodeId stmt : program.get_statements()) {
+            check_statement(stmt);
+        }
+
+        return std::move(annotations);
+    }
+
+}
@@ -0,0 +1,14 @@
+#include "../include/sema_error.hpp"
+
+namespace sema {
+
+    SemaError::SemaError(const std::string& msg) {
+        this->message = msg;
+    }
+
+    const char* SemaError::what() const noexcept {
+        formatted_msg = "Error: " + message;
+        return formatted_msg.c_str();
+    }
+
+}
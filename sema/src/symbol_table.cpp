@@ -0,0 +1,76 @@
+#include "../include/symbol_table.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace sema {
+
+    static constexpr size_t initial_buckets = 64;
+
+    SymbolTable::SymbolTable() {
+        this->buckets.assign(initial_buckets, no_slot);
+    }
+
+    size_t SymbolTable::bucket_of(const lexer::SymbolId name) const {
+        // Fibonacci hashing, SymbolIds are dense so the low bits alone cluster
+        const uint32_t h = name * 2654435769u;
+        return h >> (32 - std::countr_zero(buckets.size()));
+    }
+
+    void SymbolTable::grow() {
+        buckets.assign(buckets.size() * 2, no_slot);
+
+        for (SlotId slot = 0; slot < symbols.size(); slot++) {
+            size_t bucket = bucket_of(symbols[slot].name);
+
+            while (buckets[bucket] != no_slot) {
+                bucket = (bucket + 1) & (buckets.size() - 1);
+            }
+
+            buckets[bucket] = slot;
+        }
+    }
+
+    SlotId SymbolTable::find(const lexer::SymbolId name) const {
+        size_t bucket = bucket_of(name);
+
+        while (buckets[bucket] != no_slot) {
+            if (symbols[buckets[bucket]].name == name) {
+                return buckets[bucket];
+            }
+
+            bucket = (bucket + 1) & (buckets.size() - 1);
+        }
+
+        return no_slot;
+    }
+
+    SlotId SymbolTable::insert(const Symbol& symbol) {
+        assert(find(symbol.name) == no_slot && "Symbol already declared.");
+
+        if ((symbols.size() + 1) * 2 > buckets.size()) {
+            grow();
+        }
+
+        const auto slot = static_cast<SlotId>(symbols.size());
+        symbols.push_back(symbol);
+
+        size_t bucket = bucket_of(symbol.name);
+
+        while (buckets[bucket] != no_slot) {
+            bucket = (bucket + 1) & (buckets.size() - 1);
+        }
+
+        buckets[bucket] = slot;
+        return slot;
+    }
+
+    const Symbol& SymbolTable::operator[](const SlotId slot) const {
+        return symbols[slot];
+    }
+
+    size_t SymbolTable::size() const {
+        return symbols.size();
+    }
+
+}